@@ -15,6 +15,8 @@
  *      - [Nick Riazanov(REDID:819099418)]
  */
 #include "Disassembler.h"
+#include "InputFile.h"
+#include "Renderer.h"
 #include <string>
 #include <map>
 #include <vector>
@@ -23,85 +25,217 @@
 #include <tuple>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
 
 using namespace std;
 
-int x_reg=0;    // x register
+const static unsigned int MEMORY_SIZE = 1 << 20;    // SIC/XE has 1 MB of memory
+const static unsigned int RELOC_NEGATIVE = 0x80;    // M record subtracts load addr
+const static unsigned int RELOC_HALF_BYTES = 0x7F;  // length of field in half bytes
+const static size_t MIN_SYM_CHUNK = 1 << 16;        // smallest .sym chunk for a worker
+const static SymbolScope NO_SYMBOLS = SymbolScope();  // scope of sections w/o tables
+
+// rows of one table in .sym file, parsed by a single worker
+struct SymChunk
+{
+    // index of control section scope the rows belong to
+    unsigned int scope;
+    // true for literal table rows, false for symbol table rows
+    bool literal;
+    // [begin,end) offsets of rows in .sym file text
+    size_t begin, end;
+    // parsed rows, sorted by address
+    vector<pair<string,string>> symbols;
+    vector<pair<string,tuple<string,string,unsigned int>>> literals;
+};
+
+// orders parsed .sym rows by address
+template <typename V>
+static bool by_address(const pair<string,V> &a, const pair<string,V> &b){
+    return a.first < b.first;
+}
+// orders statements resolved by read_range() by address, then deck order
+static bool by_address_then_first(const RangeEntry &a, const RangeEntry &b){
+    if(a.address != b.address)
+        return a.address < b.address;
+    return a.first < b.first;
+}
+static bool by_first(const RangeEntry &a, const RangeEntry &b){
+    return a.first < b.first;
+}
+
 //default constructor
-Disassembler::Disassembler(){}
+Disassembler::Disassembler() : mnemonic_op(new map<string, string>()){
+    scope = &parsed;
+    x_reg = 0;
+    relocating = false;
+    load_delta = 0;
+    cache_hits = cache_misses = 0;
+    range_hits = range_misses = 0;
+    cache_section = 0;
+    sym_addrs_built = sym_addrs_sorted = false;
+}
 /**
  *  Overloaded constructor
  *  - Converts mnemonic op hex address to binary.
  *  - Maps binary address key to mnemonic symbol as value.
- *  - Opens file to log assembly instructions during runtime.
  *  - Initializes class variables.
  *  @param: mnemonic op name array, mnemonic op address array
  */
 Disassembler::Disassembler(const string mnemonics[],const string ops[]){
+    shared_ptr<map<string, string>> table(new map<string, string>());
     // loop through mnemonic ops and hex of ops.
     for(int i = 0; i < 59; i++){
         int x = hex_to_int(ops[i]);
         // converts decimal to binary, makes call to bitset
         bitset<8> b(x);
         // storing key values pairs (key: op, value: mnemonic )
-        mnemonic_op[b.to_string()] = mnemonics[i];
+        (*table)[b.to_string()] = mnemonics[i];
     }
-    // opening file to log SIC/XE statements into
-    ofs.open("out.lst", ofstream::out | ofstream::app);
+    mnemonic_op = table;
     prog_name = "";
+    scope = &parsed;
+    x_reg = 0;
+    relocating = false;
+    load_delta = 0;
+    cache_hits = cache_misses = 0;
+    range_hits = range_misses = 0;
+    cache_section = 0;
+    sym_addrs_built = sym_addrs_sorted = false;
     // hard code registers to index of their value
     registers.push_back('A');registers.push_back('X');
     registers.push_back('L');registers.push_back('B');
     registers.push_back('S');registers.push_back('T');
     registers.push_back('F');
 }
+/**
+ *  Copy constructor
+ *  - Each control section is decoded by its own copy of the Disassembler.
+ *  - Copies registers. Mnemonic table & symbol scopes are shared, not
+ *    copied, so a copy per section costs the same however big the tables
+ *    are, and decode cache entries pointing into them outlive the copy.
+ *  - Output file, decoding state (pc, base, x register) & decode cache
+ *    start out empty.
+ *  @param: disassembler to copy tables from
+ */
+Disassembler::Disassembler(const Disassembler &other)
+    : registers(other.registers), mnemonic_op(other.mnemonic_op),
+      parsed(other.parsed), scopes(other.scopes){
+    scope = (other.scope == &other.parsed ? &parsed : other.scope);
+    cache_section = other.cache_section;
+    prog_name = "";
+    pc = 0;
+    x_reg = 0;
+    relocating = false;
+    load_delta = 0;
+    cache_hits = cache_misses = 0;
+    range_hits = range_misses = 0;
+    sym_addrs_built = sym_addrs_sorted = false;
+}
+/**
+ *  open_file()
+ *  - Opens file to log assembly instructions w/o overwritting it.
+ *  @param: filename
+ *  @return: true if file opened, false otherwise.
+ */
+bool Disassembler::open_file(string filename){
+    ofs.open(filename, ofstream::out | ofstream::app);
+    return ofs.is_open();
+}
 /**
  *  read_obj_file()
- *  - Opens file containing header, text and end records.
+ *  - Opens file containing header, text and end records. gzip compressed
+ *    files are inflated while being read.
  *  - Stores all records into a vector of strings for later use.
  *  @param: filename
  *  @return: true if file opened, false otherwise.
  */
 bool Disassembler::read_obj_file(string filename){
-    ifstream file;  
-    file.open(filename);
-    string myString;
+    InputFile file;
     // check if file was opened before attempting to read
-    if(file.is_open()){
-        // read data from file object and put it into string.
-        while(getline(file, myString))
-            object_code.push_back(myString);// push data onto vector
-        file.close();   // close file after reading
+    if(file.open(filename)){
+        read_obj_stream(file.stream());
         return 1;   // return true
     }
     // output error message if file was not found/opened
     else{
-        cout<<"***ERROR***\nFile not found. Exitting program."<<endl;
+        cout<<file.get_error()<<endl;
         return 0;   //return false
     }
 }
+/**
+ *  read_obj_stream()
+ *  - Stores all records of object deck into a vector of strings.
+ *  @param: stream holding object deck
+ *  @return: none
+ */
+void Disassembler::read_obj_stream(istream &in){
+    string myString;
+    // read data from stream and put it into string.
+    while(getline(in, myString))
+        object_code.push_back(myString);// push data onto vector
+}
 /**
  *  read_header_row()
- *  - Parses through header record to extract program name, start addr & length.
- *  - Makes log to output file with the first assembly instruction to start
- *    the program.
- *  - Initializes PC to starting address given.
+ *  - Reads header record stored in object_code vector & logs it to file.
+ *  - Statements stay in render buffer if no file was opened.
  *  @param: none
  *  @return: none
  */
 void Disassembler::read_header_row(){
-    string str = object_code[0];
-    int i = 1;  // starting index of program name
-    // loop header row until we parse program name from string.
-    while(str[i]){
-        if(isalpha(str[i]))
-            prog_name += str[i];
-        else
-            break;  //exit loop if we encounter a number
-        i++;
-    }
-    start_address = str.substr(i,6);    // parse start address
-    prog_length = str.substr(i+6, 6);   // parse prog_length
+    if(object_code.empty())
+        return;
+    read_header_row(object_code[0]);
+    if(ofs.is_open())
+        ofs << take_output();
+}
+/**
+ *  read_header_row()
+ *  - Renders the first assembly instruction to start the program.
+ *  @param: header record
+ *  @return: none
+ */
+void Disassembler::read_header_row(string header){
+    parse_header(header);
+    // decoding the deck again starts from the same state
+    x_reg = 0;
+    base = "";
+    // first line of assembly code
+    Statement s(Statement::START);
+    s.address = pc;
+    s.has_address = true;
+    s.label = prog_name;
+    s.mnemonic = "START";
+    s.operand = start_address;
+    emit(s);
+}
+/**
+ *  read_csect_row()
+ *  - Renders the CSECT statement starting a control section after the first.
+ *  @param: header record of control section
+ *  @return: none
+ */
+void Disassembler::read_csect_row(string header){
+    parse_header(header);
+    Statement s(Statement::CSECT);
+    s.address = pc;
+    s.has_address = true;
+    s.label = prog_name;
+    s.mnemonic = "CSECT";
+    emit(s);
+}
+/**
+ *  parse_header()
+ *  - Parses through header record to extract program name, start addr & length.
+ *  - Initializes PC to starting address given.
+ *  @param: header record
+ *  @return: none
+ */
+void Disassembler::parse_header(string header){
+    split_header(header, prog_name, start_address, prog_length);
     // remove leading 0's from start address if any
     while(start_address.length() > 1){
         if(start_address.substr(0,1) == "0"){
@@ -111,274 +245,929 @@ void Disassembler::read_header_row(){
             break;
         }
     }
-    string s = "0000\t" + prog_name + "\t" + "START\t" + start_address + "\t\n";
-    // writing first line of assembly code to file
-    ofs << s;
     // converting start address from hex string to int to store in pc
     pc = hex_to_int(start_address);
 }
 /**
- *  parse_literal()
- *  - Parses through rows from literal table to extract:name,lit_const,len,addr.
- *  - Create tuple (name,lit_const,length).
- *  - Maps address as key to tuple created as the value.
- *  @param: row from literal table containing [name,lit_const,length,address]
+ *  split_header()
+ *  - Splits header record into program name, start address & length.
+ *  @param: header record, strings to store name, start addr & length in
  *  @return: none
  */
-void Disassembler::parse_literal(string littab_row){
-    // vector that holds strings from littab row
-    vector<string> v;
-    // i: symtab row index, v_i: vector index
-    int i = 0, v_i=0;
-    // filling vector with empty strings for concatenating info
-    for(int j = 0; j < 4; j++){
-        v.push_back("");
-    }
-    while(i < littab_row.length()){
-        // literal has no name
-        if(i == 0 && littab_row[0] == ' '){
-            v_i++;
-        }
-        // concatenate string if not a space
-        if(littab_row[i] != ' '){
-            v[v_i] += littab_row[i];
+void Disassembler::split_header(string header, string &name, string &start, string &length){
+    string str = header;
+    size_t i = 1;  // starting index of program name
+    name = "";
+    start = "";
+    length = "";
+    // loop header row until we parse program name from string.
+    while(i < str.length()){
+        if(isalpha(str[i]))
+            name += str[i];
+        else
+            break;  //exit loop if we encounter a number
+        i++;
+    }
+    // skip spaces padding names shorter than 6 chars
+    while(i < str.length() && str[i] == ' ')
+        i++;
+    if(i < str.length())
+        start = str.substr(i,6);    // parse start address
+    if(i+6 < str.length())
+        length = str.substr(i+6, 6);   // parse prog_length
+}
+/**
+ *  read_define_record()
+ *  - Define record holds pairs of (6 char name, 6 char address).
+ *  - Renders names as a single EXTDEF statement.
+ *  @param: define record
+ *  @return: none
+ */
+void Disassembler::read_define_record(string record){
+    string names = "";
+    for(size_t i = 1; i + 6 <= record.length(); i += 12){
+        string name = record.substr(i,6);
+        // names are padded with spaces to 6 chars
+        while(name.length() && name[name.length()-1] == ' ')
+            name.erase(name.length()-1);
+        if(names != "")
+            names += ",";
+        names += name;
+    }
+    Statement s(Statement::EXTDEF);
+    s.mnemonic = "EXTDEF";
+    s.operand = names;
+    emit(s);
+}
+/**
+ *  read_refer_record()
+ *  - Refer record holds 6 char names of external symbols.
+ *  - Renders names as a single EXTREF statement.
+ *  @param: refer record
+ *  @return: none
+ */
+void Disassembler::read_refer_record(string record){
+    string names = "";
+    for(size_t i = 1; i < record.length(); i += 6){
+        string name = record.substr(i,6);
+        // names are padded with spaces to 6 chars
+        while(name.length() && name[name.length()-1] == ' ')
+            name.erase(name.length()-1);
+        if(name == "")
+            continue;
+        if(names != "")
+            names += ",";
+        names += name;
+    }
+    Statement s(Statement::EXTREF);
+    s.mnemonic = "EXTREF";
+    s.operand = names;
+    emit(s);
+}
+/**
+ *  use_scope()
+ *  - Control sections are listed in the same order as symbol tables in the
+ *    .sym file. Sections without a table get empty symtab & littab.
+ *  - Tables are selected, not copied.
+ *  - Each section keeps its own decode cache, so switching back to a
+ *    section reuses the decisions made for it before. An empty cache is
+ *    not parked, so a fresh copy selecting its section does no work.
+ *  @param: index of control section in deck
+ *  @return: none
+ */
+void Disassembler::use_scope(unsigned int section){
+    const SymbolScope *s = get_scope(section);
+    scope = (s ? s : &NO_SYMBOLS);
+    if(section != cache_section){
+        if(!cache.empty())
+            swap(cache, parked_caches[cache_section]);
+        map<unsigned int, DecodeCache>::iterator it = parked_caches.find(section);
+        if(it != parked_caches.end()){
+            swap(cache, it->second);
+            parked_caches.erase(it);
         }
-        // increment vector index at the end of each string before space
-        if(v[v_i] != "" && littab_row[i]==' '){
-            v_i++;
+        else
+            cache = DecodeCache();
+        cache_section = section;
+    }
+    sym_addrs.clear();
+    sym_addrs_built = sym_addrs_sorted = false;
+}
+/**
+ *  clear_decode_cache()
+ *  - Cached decisions depend on littab & cached labels point into symtab.
+ *  @param: none
+ *  @return: none
+ */
+void Disassembler::clear_decode_cache(){
+    cache = DecodeCache();
+    parked_caches.clear();
+    sym_addrs.clear();
+    sym_addrs_built = sym_addrs_sorted = false;
+}
+/**
+ *  swap_decode_cache()
+ *  - Cached labels point into the symbol scopes, so other must share them.
+ *  @param: index of control section in deck, disassembler w/ section
+ *          selected
+ *  @return: none
+ */
+void Disassembler::swap_decode_cache(unsigned int section, Disassembler &other){
+    swap(section == cache_section ? cache : parked_caches[section], other.cache);
+}
+/**
+ *  get_scope()
+ *  @param: index of control section in deck
+ *  @return: symbol & literal tables of section, null if it has none
+ */
+const SymbolScope *Disassembler::get_scope(unsigned int section) const{
+    if(scopes && section < scopes->size())
+        return &(*scopes)[section];
+    return NULL;
+}
+const vector<unsigned char> &Disassembler::get_image() const{
+    return image;
+}
+const vector<char> &Disassembler::get_registers() const{
+    return registers;
+}
+/**
+ *  load_text_record()
+ *  - Text record holds start address (6), length in bytes (2), object code.
+ *  - Copies object code bytes into image at their address.
+ *  @param: text record
+ *  @return: none
+ */
+void Disassembler::load_text_record(string record){
+    if(record.length() < 9)
+        return;
+    unsigned int addr = hex_to_int(record.substr(1,6));
+    unsigned int length = hex_to_int(record.substr(7,2));
+    // only load bytes actually present in record
+    if(length > (record.length() - 9) / 2)
+        length = (record.length() - 9) / 2;
+    if(addr >= MEMORY_SIZE || addr + length > MEMORY_SIZE)
+        return;     // not an address in memory
+    if(image.size() < addr + length)
+        image.resize(addr + length, 0);
+    for(unsigned int i = 0; i < length; i++)
+        image[addr + i] = hex_to_int(record.substr(9 + i*2, 2));
+}
+/**
+ *  read_modification_record()
+ *  - Modification record holds address (6), length in half bytes (2) and an
+ *    optional sign & symbol. Symbol must be this control section, external
+ *    symbols are resolved by a linking loader so they are skipped.
+ *  - Packs record into the relocation index.
+ *  @param: modification record
+ *  @return: none
+ */
+void Disassembler::read_modification_record(string record){
+    if(record.length() < 9)
+        return;
+    unsigned int entry = hex_to_int(record.substr(1,6)) << 8;
+    entry |= hex_to_int(record.substr(7,2)) & RELOC_HALF_BYTES;
+    if(record.length() > 9){
+        string symbol = record.substr(10);
+        // symbols are padded with spaces to 6 chars
+        while(symbol.length() && symbol[symbol.length()-1] == ' ')
+            symbol.erase(symbol.length()-1);
+        if(symbol != "" && symbol != prog_name)
+            return;
+        if(record[9] == '-')
+            entry |= RELOC_NEGATIVE;
+    }
+    relocations.push_back(entry);
+}
+/**
+ *  relocate()
+ *  - Sorts relocation index by address.
+ *  - Adds (or subtracts) delta to every field in image named by a
+ *    modification record. Odd length fields start at the low half byte.
+ *  - Statements decoded afterwards are listed at their loaded address.
+ *  @param: bytes control section is moved by, load address - start address
+ *  @return: none
+ */
+void Disassembler::relocate(unsigned int delta){
+    sort(relocations.begin(), relocations.end());
+    for(size_t i = 0; i < relocations.size(); i++){
+        unsigned int addr = relocations[i] >> 8;
+        unsigned int half_bytes = relocations[i] & RELOC_HALF_BYTES;
+        unsigned int num_bytes = (half_bytes + 1) / 2;
+        if(half_bytes == 0 || half_bytes > 8 || addr + num_bytes > image.size())
+            continue;   // field is not in image
+        unsigned long long value = 0, mask = (1ULL << (half_bytes * 4)) - 1;
+        for(unsigned int j = 0; j < num_bytes; j++)
+            value = (value << 8) | image[addr + j];
+        unsigned long long field = value & mask;
+        if(relocations[i] & RELOC_NEGATIVE)
+            field -= delta;
+        else
+            field += delta;
+        value = (value & ~mask) | (field & mask);
+        for(int j = num_bytes - 1; j >= 0; j--){
+            image[addr + j] = value & 0xFF;
+            value >>= 8;
         }
-        i++;
+    }
+    relocating = true;
+    load_delta = delta;
+    // header statement is queued before the section is relocated
+    for(size_t i = 0; i < statements.size(); i++)
+        if(statements[i].has_address)
+            statements[i].address += delta;
+}
+/**
+ *  relocate_code()
+ *  - Searches relocation index for a field inside the statement at address.
+ *  - Relocated statements list object code from the relocated image.
+ *  @param: address of statement, reference to object code of statement in hex
+ *  @return: true if statement was relocated, false otherwise.
+ */
+bool Disassembler::relocate_code(unsigned int addr, string &obj_code){
+    if(!relocating)
+        return false;
+    unsigned int end = addr + obj_code.length() / 2;
+    // first modification record at or after address
+    vector<unsigned int>::iterator it;
+    it = lower_bound(relocations.begin(), relocations.end(), addr << 8);
+    if(it == relocations.end() || (*it >> 8) >= end || end > image.size())
+        return false;
+    string code = "";
+    for(unsigned int a = addr; a < end; a++){
+        string byte = decimal_to_hex(image[a]);
+        to_uppercase(byte);
+        add_offset_bits(2, byte);
+        code += byte;
+    }
+    obj_code = code;
+    return true;
+}
+/**
+ *  next_field()
+ *  - Fields of symbol & literal table rows are separated by spaces.
+ *  @param: row, position to search from (moved past field), field to fill in
+ *  @return: false if no field is left in row
+ */
+static bool next_field(const string &row, size_t &pos, string &field){
+    size_t start = row.find_first_not_of(' ', pos);
+    if(start == string::npos)
+        return false;
+    pos = row.find(' ', start);
+    if(pos == string::npos)
+        pos = row.size();
+    field.assign(row, start, pos - start);
+    return true;
+}
+/**
+ *  split_literal()
+ *  - Parses through rows from literal table to extract:name,lit_const,len,addr.
+ *  - Create tuple (name,lit_const,length).
+ *  @param: row from literal table containing [name,lit_const,length,address],
+ *          address & tuple to fill in
+ *  @return: none
+ */
+void Disassembler::split_literal(const string &littab_row, string &addr,
+                                 tuple<string,string,unsigned int> &lit){
+    // strings from littab row: name, lit_const, length, address
+    string v[4];
+    size_t pos = 0;
+    // literal has no name when row starts w/ space. Extra columns are ignored.
+    for(int v_i = (littab_row[0] == ' ' ? 1 : 0); v_i < 4; v_i++){
+        if(!next_field(littab_row, pos, v[v_i]))
+            break;
     }
     // store name, lit_constant and length to tuple
-    tuple<string,string,int> t (v[0],v[1],stoi(v[2]));
+    lit = make_tuple(v[0], v[1], (unsigned int)atoi(v[2].c_str()));
+    addr = v[3];
+}
+/**
+ *  parse_literal()
+ *  - Maps address as key to tuple (name,lit_const,length) as the value.
+ *  @param: row from literal table containing [name,lit_const,length,address]
+ *  @return: none
+ */
+void Disassembler::parse_literal(string littab_row){
+    string addr;
+    tuple<string,string,unsigned int> t;
+    split_literal(littab_row, addr, t);
+    edit_scope();
     // address is the key, tuple is the value
-    littab[v[3]] = t;
+    parsed.littab[addr] = t;
+    clear_decode_cache();
 }
 /**
- *  parse_symbol()
+ *  split_symbol()
  *  - Parses through rows from symbol table to extract symbol name and address.
+ *  @param: row from symbol table containing symbol and address, address &
+ *          symbol to fill in
+ *  @return: none
+ */
+void Disassembler::split_symbol(const string &symtab_row, string &addr, string &name){
+    size_t pos = 0;
+    name = addr = "";
+    if(next_field(symtab_row, pos, name))
+        next_field(symtab_row, pos, addr);
+}
+/**
+ *  parse_symbol()
  *  - Maps address as the key to the symbol as the value.
  *  @param: row from symbol table containing symbol and address.
  *  @return: none
  */
 void Disassembler::parse_symbol(string symtab_row){
-    vector<string> v;
-    // i: symtab row index, v_i: vector index
-    int i = 0, v_i = 0;
-    // filling array with empty string to later concatenate symbol row
-    v.push_back(""); v.push_back("");
-    while(i < symtab_row.length() && v_i < v.size()){
-        if(symtab_row[i] != ' '){
-            v[v_i] += symtab_row[i];
-        }
-        // increment vector index at the end of each string before space
-        if(v[v_i] != "" && symtab_row[i]==' '){
-            v_i++;
-        }
-        i++;
-    }
+    string addr, name;
+    split_symbol(symtab_row, addr, name);
+    edit_scope();
     // map address as key to symbol value
-    symtab[v[1]] = v[0];
+    parsed.symtab[addr] = name;
+    clear_decode_cache();
+}
+/**
+ *  edit_scope()
+ *  - Shared scopes are read-only. Rows added to a selected scope go to a
+ *    private copy of it instead.
+ *  @param: none
+ *  @return: none
+ */
+void Disassembler::edit_scope(){
+    if(scope != &parsed){
+        parsed = *scope;
+        scope = &parsed;
+    }
 }
 /**
  *  read_sym_file()
- *  - Opens .sym file to extract info from symtab and littab.
- *  - Parses file line by line to extract symbol info and literal info.
- *  - Makes function call to parse literal or parse symbol to store in hash map.
- *  @param: filename
- *  @return: true if file was opened, false otherwise.
- */
-bool Disassembler::read_sym_file(string filename){
-    ifstream file;  
-    file.open(filename);
-    string myString, key, val;
-    vector<string> v;   // stores each line of the .sym file
-    if(file.is_open()){
-        // read data from file object and put it into string.
-        while(getline(file, myString)){
-            v.push_back(myString);
+ *  - Opens .sym file to extract info from symtab and littab. gzip compressed
+ *    files are inflated while being read.
+ *  @param: filename, number of worker threads parsing tables
+ *  @return: true if file was opened & read, false otherwise.
+ */
+bool Disassembler::read_sym_file(string filename, unsigned int workers){
+    InputFile file;
+    if(file.open(filename)){
+        read_sym_stream(file.stream(), workers);
+        if(file.is_corrupt()){
+            cout<<"***ERROR***\nCompressed symbol file is corrupt."<<endl;
+            return 0;
         }
-        int sym_flag=0,lflag=0;
-        // loop through rows of symbol file
-        for(int i = 0; i < v.size(); i++){
-            // check if row is greater than 1 character, else its a newline
-            if(v[i].size() > 1){
-                // check if parsed string is start of symbol table
-                if(v[i].substr(0,6) == "Symbol"){
-                    sym_flag = 1;   // flag for symbol table
-                }
-                // check if parse string is start of literal table
-                else if(v[i].substr(0,4)=="Name"){
-                    sym_flag = 0;
-                    lflag = 1;  //flag for literal table
+        return 1; // return true
+    }
+    else{
+        cout<<file.get_error()<<endl;
+        return 0;   //return false
+    }
+}
+/**
+ *  parse_sym_chunks()
+ *  - Worker loop. Takes chunks in turn until none are left and parses their
+ *    rows into the chunk's local vector, sorted by address. Rows for the same
+ *    address keep their file order.
+ *  @param: symbol file text, chunks, index of next chunk to take
+ *  @return: none
+ */
+static void parse_sym_chunks(const string *text, vector<SymChunk> *chunks,
+                             atomic<size_t> *next_chunk){
+    size_t i;
+    while((i = (*next_chunk)++) < chunks->size()){
+        SymChunk &c = (*chunks)[i];
+        size_t pos = c.begin;
+        while(pos < c.end){
+            size_t eol = text->find('\n', pos);
+            if(eol == string::npos || eol > c.end)
+                eol = c.end;
+            // skip newlines & table underlines
+            if(eol - pos > 1 && (*text)[pos] != '-'){
+                string row = text->substr(pos, eol - pos);
+                string addr;
+                if(c.literal){
+                    tuple<string,string,unsigned int> lit;
+                    Disassembler::split_literal(row, addr, lit);
+                    c.literals.push_back(make_pair(addr, lit));
                 }
                 else{
-                    // check symbol flag
-                    if(sym_flag && v[i][0] != '-'){
-                        myString = v[i];
-                        parse_symbol(myString);
-                    }
-                    // check literal flag
-                    if(lflag && v[i][0] != '-'){
-                        myString = v[i];
-                        parse_literal(myString);
-                    }
+                    string name;
+                    Disassembler::split_symbol(row, addr, name);
+                    c.symbols.push_back(make_pair(addr, name));
                 }
             }
+            pos = eol + 1;
         }
-        file.close(); // close file after reading
-        return 1; // return true
+        stable_sort(c.symbols.begin(), c.symbols.end(), by_address<string>);
+        stable_sort(c.literals.begin(), c.literals.end(),
+                    by_address<tuple<string,string,unsigned int>>);
     }
-    else{
-        cout<<"***ERROR***\nFile not found. Exitting program."<<endl;
-        return 0;   //return false
+}
+/**
+ *  merge_rows()
+ *  - Merges sorted rows of a table's chunks, in file order, into the table.
+ *    Chunks are joined once, then neighbouring runs are merged pairwise
+ *    until one is left, so each row is moved log(chunks) times. Merges are
+ *    stable, so when an address is listed more than once the last row wins.
+ *  @param: rows of each chunk, table to fill in
+ *  @return: none
+ */
+template <typename V>
+static void merge_rows(vector<vector<pair<string,V>>*> &parts, map<string,V> &table){
+    size_t total = 0;
+    for(size_t i = 0; i < parts.size(); i++)
+        total += parts[i]->size();
+    vector<pair<string,V>> rows;
+    rows.reserve(total);
+    vector<size_t> runs(1, 0);  // start of each sorted run, then end of rows
+    for(size_t i = 0; i < parts.size(); i++){
+        rows.insert(rows.end(), make_move_iterator(parts[i]->begin()),
+                    make_move_iterator(parts[i]->end()));
+        runs.push_back(rows.size());
+    }
+    while(runs.size() > 2){
+        vector<size_t> merged(1, 0);
+        for(size_t r = 0; r+1 < runs.size(); r += 2){
+            if(r+2 < runs.size()){
+                inplace_merge(rows.begin() + runs[r], rows.begin() + runs[r+1],
+                              rows.begin() + runs[r+2], by_address<V>);
+            }
+            merged.push_back(runs[min(r+2, runs.size()-1)]);
+        }
+        runs.swap(merged);
+    }
+    for(size_t i = 0; i < rows.size(); i++){
+        if(i+1 < rows.size() && rows[i+1].first == rows[i].first)
+            continue;
+        // rows are sorted, so hint at end keeps inserting linear
+        table.emplace_hint(table.end(), std::move(rows[i].first), V())->second
+            = std::move(rows[i].second);
+    }
+}
+/**
+ *  read_sym_stream()
+ *  - Reads whole symbol file, then finds where each Symbol & Name table
+ *    starts before any row is parsed. Each Symbol table starts the scope of
+ *    the next control section.
+ *  - Rows of each table are split at line boundaries into chunks which are
+ *    parsed on worker threads, then merged into symtab & littab of their
+ *    scope.
+ *  @param: stream holding symbol file, number of worker threads
+ *  @return: none
+ */
+void Disassembler::read_sym_stream(istream &file, unsigned int workers){
+    ostringstream ss;
+    ss << file.rdbuf();
+    string text = ss.str();
+    if(workers == 0)
+        workers = 1;
+    // a few chunks per worker so uneven tables still balance
+    size_t chunk_bytes = max(MIN_SYM_CHUNK, text.size() / (workers * 4));
+    vector<SymChunk> chunks;
+    unsigned int num_tables = 0;    // symbol tables read so far
+    bool in_table = false;
+    size_t pos = 0;
+    while(pos < text.size()){
+        size_t eol = text.find('\n', pos);
+        if(eol == string::npos)
+            eol = text.size();
+        // check if row is greater than 1 character, else its a newline
+        bool sym_header = (eol - pos > 1 && text.compare(pos, 6, "Symbol") == 0);
+        bool lit_header = (eol - pos > 1 && text.compare(pos, 4, "Name") == 0);
+        if(sym_header || lit_header){
+            if(in_table)
+                chunks.back().end = pos;
+            if(sym_header)
+                num_tables++;
+            SymChunk c;
+            c.scope = (num_tables ? num_tables - 1 : 0);
+            c.literal = lit_header;
+            c.begin = c.end = min(eol + 1, text.size());
+            chunks.push_back(c);
+            in_table = true;
+        }
+        else if(in_table && pos - chunks.back().begin >= chunk_bytes){
+            chunks.back().end = pos;
+            SymChunk c = chunks.back();
+            c.begin = pos;
+            chunks.push_back(c);
+        }
+        pos = eol + 1;
+    }
+    if(in_table)
+        chunks.back().end = text.size();
+
+    atomic<size_t> next_chunk(0);
+    vector<thread> threads;
+    for(unsigned int i = 1; i < workers && i < chunks.size(); i++)
+        threads.push_back(thread(parse_sym_chunks, &text, &chunks, &next_chunk));
+    parse_sym_chunks(&text, &chunks, &next_chunk);
+    for(size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    // rows read earlier belong to first control section
+    vector<SymbolScope> tables(max(num_tables, 1u));
+    tables[0].symtab.swap(parsed.symtab);
+    tables[0].littab.swap(parsed.littab);
+    for(size_t t = 0; t < tables.size(); t++){
+        vector<vector<pair<string,string>>*> sym_parts;
+        vector<vector<pair<string,tuple<string,string,unsigned int>>>*> lit_parts;
+        for(size_t i = 0; i < chunks.size(); i++){
+            if(chunks[i].scope != t)
+                continue;
+            if(chunks[i].literal)
+                lit_parts.push_back(&chunks[i].literals);
+            else
+                sym_parts.push_back(&chunks[i].symbols);
+        }
+        merge_rows(sym_parts, tables[t].symtab);
+        merge_rows(lit_parts, tables[t].littab);
+    }
+    // copies of this Disassembler keep the scopes they were made with
+    shared_ptr<vector<SymbolScope>> all(new vector<SymbolScope>());
+    if(scopes)
+        *all = *scopes;
+    for(size_t t = 0; t < tables.size(); t++){
+        all->push_back(SymbolScope());
+        all->back().symtab.swap(tables[t].symtab);
+        all->back().littab.swap(tables[t].littab);
     }
+    scopes = all;
+    clear_decode_cache();   // cached labels point into the old scopes
+    use_scope(0);   // first control section is selected by default
 }
 /**
  *  read_text_record()
  *  - Loops through object_code vector which stores all Text records
- *  - Iterate through each text record and determine format for each object code
- *  - Once format determined, call write_to_output() to log assembly instruction
- *  - If no format, then determine byte instruction.
- *  - Handles case for RESB instruction and determine bytes needed using offset
- *    from current addresses and address of next instruction.
+ *  - Logs statements rendered for each record to output file.
  *  @param: none
  *  @return: none
  */
 void Disassembler::read_text_record(){
     //Looping through vector which holds all object code records. Only looping through text records.
-    for(int i = 1; i < object_code.size()-1; i++){
-        string str = object_code[i];    // text record string
-        string obj_code,temp,const_type;    // helper vars
-        map<string,string>::iterator it;    // symtab iterator
-        // stores address within range of PC and start of next T record.
-        vector<string> addr_in_range;
-        int offset; // stores decimal value of offset in bits
-        unsigned int curr_address; 
-        int index = 9;  // index of first object code on any text record
-        string mnemonic = "";   // mnemonic instruction string
-        // loop through text record string
-        while(index < str.length()-1){
-            curr_address = pc;  // storing current address as decimal value
-            //checking all format instructions in while loop & if curr_address is a literal addr.
-            if(str.substr(0,1) == "M")
-                break;
-            //check if format 2 instruction.
-            else if(is_format_2(str.substr(index,2)) && !is_in_littab(curr_address)){
-                // return mnemonic instruction from symtab
-                mnemonic = get_mnemonic_op(str.substr(index,2),2);
-                // uppercase and lowercase alphabetical chars.
-                temp = decimal_to_hex(curr_address);
-                to_uppercase(temp);
-                // add extra 0's to hex
-                add_offset_bits(4, temp);   // 4 nibbles needed for printing memory loc
-                char reg = registers[hex_to_int(str.substr(index+2,1))];
-                if(mnemonic == "CLEAR"){
-                    if(reg == 'X')
-                        x_reg = 0;
-                }
-                ofs << temp +"\t\t" << mnemonic<<"\t"<<reg<<"\t\t"<<str.substr(index,4)<<endl;
-                pc += 2;    //update pc counter
-                index += 4; //update index to point to next object code
+    for(size_t i = 1; i+1 < object_code.size(); i++){
+        read_text_record(object_code[i], object_code[i+1]);
+        if(ofs.is_open())
+            ofs << take_output();
+    }
+}
+/**
+ *  resolve_records()
+ *  - Base & x register carry over from one record to the next, so records
+ *    are resolved in deck order, starting from the header. The state each
+ *    record started in is kept, so records added to object_code since are
+ *    resolved from where the last query stopped. The last record resolved
+ *    before listed RESB up to the end of the program, so it is done again.
+ *  - Statements queued before stay queued.
+ *  @param: none
+ *  @return: none
+ */
+void Disassembler::resolve_records(){
+    size_t total = (object_code.size() > 2 ? object_code.size() - 2 : 0);
+    vector<RecordState> &records = cache.records;
+    if(records.size() >= total)
+        return;
+    vector<Statement> queued;
+    statements.swap(queued);
+    read_header_row(object_code[0]);
+    statements.clear();
+    size_t next = 0;    // first record to resolve
+    if(!records.empty()){
+        next = records.size() - 1;
+        pc = records[next].pc;
+        base = records[next].base;
+        x_reg = records[next].x_reg;
+        cache.statements.erase(cache.statements.begin() + records[next].first,
+                               cache.statements.end());
+        records.resize(next);
+    }
+    for(size_t i = next; i < total; i++){
+        RecordState r = {pc, base, x_reg, cache.statements.size()};
+        records.push_back(r);
+        read_text_record(object_code[i+1], object_code[i+2]);
+        range_misses += statements.size();
+        cache.statements.insert(cache.statements.end(), statements.begin(), statements.end());
+        statements.clear();
+    }
+    statements.swap(queued);
+    // statements w/o address (LTORG) go w/ the statement following them
+    vector<RangeEntry> &index = cache.by_address;
+    index.clear();
+    cache.in_order = true;
+    size_t pending = 0;
+    for(size_t i = 0; i < cache.statements.size(); i++){
+        if(!cache.statements[i].has_address)
+            continue;
+        RangeEntry e = {cache.statements[i].address, pending, i};
+        if(!index.empty() && e.address < index.back().address)
+            cache.in_order = false;
+        index.push_back(e);
+        pending = i + 1;
+    }
+    if(!cache.in_order)
+        sort(index.begin(), index.end(), by_address_then_first);
+}
+/**
+ *  read_range()
+ *  - Statements are resolved the first time the deck is queried, then
+ *    handed over from the decode cache: a query is a binary search for its
+ *    lowest address & a copy of the statements up to its highest.
+ *  - Statements w/o address (LTORG) go w/ the statement following them.
+ *  - Statements are handed over in deck order, like read_text_record()
+ *    decodes them.
+ *  @param: lowest address, address after highest, vector to add statements to
+ *  @return: none
+ */
+void Disassembler::read_range(unsigned int from, unsigned int to, vector<Statement> &v){
+    unsigned long long resolved = range_misses;
+    resolve_records();
+    bool cached = (range_misses == resolved);   // no record resolved by query
+    const vector<RangeEntry> &index = cache.by_address;
+    RangeEntry key = {from, 0, 0};
+    vector<RangeEntry>::const_iterator it = lower_bound(index.begin(), index.end(),
+                                                        key, by_address_then_first);
+    vector<RangeEntry> found;
+    for(; it != index.end() && it->address < to; it++)
+        found.push_back(*it);
+    if(!cache.in_order)
+        sort(found.begin(), found.end(), by_first);
+    for(size_t i = 0; i < found.size(); i++){
+        v.insert(v.end(), cache.statements.begin() + found[i].first,
+                 cache.statements.begin() + found[i].last + 1);
+        if(cached)
+            range_hits += found[i].last + 1 - found[i].first;
+    }
+}
+/**
+ *  read_text_record()
+ *  - Iterate through text record and determine format for each object code
+ *  - Once format determined, call write_to_output() to log assembly instruction
+ *  - If no format, then determine byte instruction. Bytes which are neither
+ *    an instruction nor in littab are listed one at a time as BYTE.
+ *  - Handles case for RESB instruction and determine bytes needed using offset
+ *    from current addresses and address of next instruction.
+ *  - Format of each address is decided once & kept in the decode cache. It
+ *    is reused while the record has the same text there; operands still
+ *    depend on pc, base & x register so they are resolved every time.
+ *  @param: text record, record following it in the deck
+ *  @return: none
+ */
+void Disassembler::read_text_record(string record, string next_record){
+    string str = record;    // text record string
+    string obj_code,temp,const_type;    // helper vars
+    // stores address within range of PC and start of next T record.
+    vector<string> addr_in_range;
+    int offset; // stores decimal value of offset in bits
+    unsigned int curr_address; 
+    int index = 9;  // index of first object code on any text record
+    string mnemonic = "";   // mnemonic instruction string
+    int start_pc = pc;      // address of first object code
+    bool cached = check_decoded_text(pc, str);
+    // loop through text record string
+    while(index+1 < (int)str.length()){
+        curr_address = pc;  // storing current address as decimal value
+        //checking all format instructions in while loop & if curr_address is a literal addr.
+        if(str.substr(0,1) == "M")
+            break;
+        // odd length constants leave text out of step w/ pc, so stop caching
+        if(index - 9 != 2 * (pc - start_pc))
+            cached = false;
+        DecodeEntry decoded;
+        unsigned char avail = min(str.length() - index, (size_t)8);
+        char tail = str[str.length()-1];
+        DecodeEntry *entry = (cached ? &cache.entries[curr_address - cache.base] : NULL);
+        if(entry && entry->avail == avail && (avail % 2 == 0 || entry->tail == tail)){
+            decoded = *entry;
+            cache_hits++;
+        }
+        else{
+            decoded = decode_entry(str, index, curr_address);
+            decoded.avail = avail;
+            decoded.tail = tail;
+            if(entry){
+                decoded.label = entry->label;
+                *entry = decoded;
             }
-            // check format 4 instruction
-            else if(is_format_4(str.substr(index,8)) && !is_in_littab(curr_address)){
-                mnemonic = get_mnemonic_op(str.substr(index, 2),4);
-                //parsing object code from text record
-                obj_code = str.substr(index,8);
-                pc += 4;    //update pc counter
-                index += 8; //update index to point to next object code
-                //format parameters into SIX/XE source code to write to output file.
-                write_to_output(curr_address,obj_code,mnemonic);
+            cache_misses++;
+        }
+        mnemonic = (decoded.mnemonic ? *decoded.mnemonic : "");
+        //check if format 2 instruction.
+        if(decoded.format == 2){
+            unsigned int r = hex_to_int(str.substr(index+2,1));
+            char reg = (r < registers.size() ? registers[r] : '?');
+            if(mnemonic == "CLEAR"){
+                if(reg == 'X')
+                    x_reg = 0;
             }
-            // else if format 3
-            else if(is_format_3(str.substr(index,6)) && !is_in_littab(curr_address)){
-                mnemonic = get_mnemonic_op(str.substr(index, 2),3);
-                //parsing object code from text record
-                obj_code = str.substr(index,6);
-                pc += 3;    //update pc counter
-                index += 6; //update index to point to next object code
-                //format parameters into SIX/XE source code to write to output
-                write_to_output(curr_address,obj_code,mnemonic);
+            Statement s(Statement::REGISTER);
+            s.address = curr_address;
+            s.has_address = true;
+            s.label = get_symbol(curr_address);
+            s.mnemonic = mnemonic;
+            s.operand = string(1, reg);
+            s.obj_code = str.substr(index,4);
+            s.relocated = relocate_code(curr_address, s.obj_code);
+            s.format = 2;
+            emit(s);
+            pc += 2;    //update pc counter
+            index += 4; //update index to point to next object code
+        }
+        // check format 4 instruction
+        else if(decoded.format == 4){
+            //parsing object code from text record
+            obj_code = str.substr(index,8);
+            pc += 4;    //update pc counter
+            index += 8; //update index to point to next object code
+            //format parameters into SIX/XE source code to write to output file.
+            write_to_output(curr_address,obj_code,mnemonic,decoded.flags);
+        }
+        // else if format 3
+        else if(decoded.format == 3){
+            //parsing object code from text record
+            obj_code = str.substr(index,6);
+            pc += 3;    //update pc counter
+            index += 6; //update index to point to next object code
+            //format parameters into SIX/XE source code to write to output
+            write_to_output(curr_address,obj_code,mnemonic,decoded.flags);
+        }
+        else{
+            // tuple returned from littab hashmap
+            // auto[name, lit_const, length] = get_literal(curr_address);
+            tuple<string,string,int> mytuple = get_literal(curr_address);
+            string name = get<0>(mytuple);
+            string lit_const = get<1>(mytuple);
+            int length = get<2>(mytuple);
+            // no constant at address, list a single byte
+            if(length <= 0){
+                name = get_symbol(curr_address);
+                lit_const = "X'" + str.substr(index,2) + "'";
+                length = 2;
+            }
+            // check first char in lit_const to see if it is a literal.
+            if(lit_const[0] == '='){
+                const_type = '*';       // symbol for literal constant
+                emit(Statement(Statement::LTORG));
             }
+            // else, it is a byte constant
             else{
-                // tuple returned from littab hashmap
-                // auto[name, lit_const, length] = get_literal(curr_address);
-                tuple<string,string,int> mytuple = get_literal(curr_address);
-                string name = get<0>(mytuple);
-                string lit_const = get<1>(mytuple);
-                int length = get<2>(mytuple);
-                // check first char in lit_const to see if it is a literal.
-                if(lit_const[0] == '='){
-                    const_type = '*';       // symbol for literal constant
-                    int end_addr = hex_to_int(prog_length);
-                    int temp = length/2;
-                    ofs <<"\t\tLTORG\n";
-                }
-                // else, it is a byte constant
-                else{
-                    const_type = "BYTE";
-                }
-                // convert decimal address to hex
-                temp = decimal_to_hex(curr_address);    //temp holder of hex_string
-                // capitalize alphabetical chars in hex address
-                to_uppercase(temp);
-                // add extra 0's to hex
-                add_offset_bits(4, temp);   // 4 nibbles needed for printing memory loc
-                string temp_obj_code = str.substr(index,length);
-                if(temp_obj_code.length() < 4)
-                    temp_obj_code = '\t' + temp_obj_code;
-                ofs <<temp<<'\t'<<name<<'\t'<<const_type<<"\t"<<lit_const<<'\t'<<temp_obj_code<<endl;
-                pc += (length/2);   // update pc register 
-                index += length;    // increment index to point to next obj_code
+                const_type = "BYTE";
             }
-        }//while
-        //check if there is another record in the object code vector.
-        if(i+1 <= object_code.size()-1){
-            int dec1,dec2;  //decimal ints
-            string next_start_addr; //starting address of next SIC/XE statement.
-            vector<int> RESB;   //contains the reserved bytes for each symbol.
-            //check if next record is text record
-            if(object_code[i+1].substr(0,1) == "T")
-                next_start_addr = object_code[i+1].substr(1,6);//start addr of next T record.
-            else
-                next_start_addr = prog_length;  //else, next address is end address.
-            offset = hex_to_int(next_start_addr);   //next addr as int
-            //iterate through symtab
-            for(it = symtab.begin(); it != symtab.end(); it++){
-                // convert hex string to decimal integer
-                dec1 = hex_to_int(it->first);
-                //if address of symbol in range between PC and next address. Add symbol to vector.
-                if(dec1 >= pc && dec1 <= offset)
-                    addr_in_range.push_back(it->first);
+            Statement s(Statement::CONSTANT);
+            s.address = curr_address;
+            s.has_address = true;
+            s.label = name;
+            s.mnemonic = const_type;
+            s.operand = lit_const;
+            s.obj_code = str.substr(index,length);
+            s.relocated = relocate_code(curr_address, s.obj_code);
+            emit(s);
+            pc += (length/2);   // update pc register 
+            index += length;    // increment index to point to next obj_code
+        }
+    }//while
+    //determine reserved bytes up to the start of the next record.
+    int dec1,dec2;  //decimal ints
+    string next_start_addr; //starting address of next SIC/XE statement.
+    vector<int> RESB;   //contains the reserved bytes for each symbol.
+    //check if next record is text record
+    if(next_record.substr(0,1) == "T")
+        next_start_addr = next_record.substr(1,6);//start addr of next T record.
+    else
+        next_start_addr = prog_length;  //else, next address is end address.
+    offset = hex_to_int(next_start_addr);   //next addr as int
+    //symbols w/ address in range between PC and next address.
+    find_symbols(pc, offset, addr_in_range);
+    // if any symbols found within range of PC & next address
+    if(addr_in_range.size()){
+        //loop through symbols in range of PC & next address
+        for(size_t j = 0; j < addr_in_range.size(); j++){
+            // converting hex string to decimal integer
+            dec1 = hex_to_int(addr_in_range[j]);
+            //check if element in next index
+            if(j+1 < addr_in_range.size()){
+                //convert next symbol address to decimal
+                dec2 = hex_to_int(addr_in_range[j+1]);
+                //push the offset from address into RESB.
+                RESB.push_back(dec2 - dec1);
+                pc += dec2-dec1;                //update pc
             }
-            // if any symbols found within range of PC & next address
-            if(addr_in_range.size()){
-                //loop through symbols in range of PC & next address
-                for(int j = 0; j < addr_in_range.size(); j++){
-                    // converting hex string to decimal integer
-                    dec1 = hex_to_int(addr_in_range[j]);
-                    //check if element in next index
-                    if(j+1 < addr_in_range.size()){
-                        //convert next symbol address to decimal
-                        dec2 = hex_to_int(addr_in_range[j+1]);
-                        //push the offset from address into RESB.
-                        RESB.push_back(dec2 - dec1);
-                        pc += dec2-dec1;                //update pc
-                    }
-                    // reached last address in range,get offset w/ next start addr.
-                    else{
-                        RESB.push_back(offset-dec1);
-                        pc += offset - dec1;
-                    }
-                }
-                //loop through RESB vector and print lines
-                for(int j = 0; j < RESB.size(); j++){
-                    ofs <<addr_in_range[j].substr(2,4)<<"\t"<<symtab[addr_in_range[j]]<< "\tRESB\t" << RESB[j]<<'\n';
-                }
+            // reached last address in range,get offset w/ next start addr.
+            else{
+                RESB.push_back(offset-dec1);
+                pc += offset - dec1;
             }
         }
-    }//for
+        //loop through RESB vector and print lines
+        for(size_t j = 0; j < RESB.size(); j++){
+            Statement s(Statement::RESB);
+            s.address = hex_to_int(addr_in_range[j]);
+            s.has_address = true;
+            s.label = scope->symtab.find(addr_in_range[j])->second;
+            s.mnemonic = "RESB";
+            stringstream count;
+            count << RESB[j];
+            s.operand = count.str();
+            emit(s);
+        }
+    }
+}
+/**
+ *  check_decoded_text()
+ *  - Decisions at an address only depend on text of the record they were
+ *    made in, so they are dropped when a record w/ different text covers
+ *    any char they read. Labels are kept.
+ *  - An odd last char (e.g. '\r') would share a byte w/ the next record, so
+ *    it is kept by the decisions that read it instead.
+ *  - Cache only spans addresses decoded so far, so a section loaded high in
+ *    memory doesn't hold entries for every address below it.
+ *  @param: address of first object code, text record
+ *  @return: true if record is within memory & its decisions are cached
+ */
+bool Disassembler::check_decoded_text(unsigned int addr, const string &record){
+    if(record.length() < 11 || addr >= MEMORY_SIZE)
+        return false;
+    size_t chars = (record.length() - 9) & ~(size_t)1;
+    size_t end = addr + chars / 2;      // address after last whole byte
+    if(end > MEMORY_SIZE)
+        return false;
+    vector<DecodeEntry> &entries = cache.entries;
+    if(entries.empty())
+        cache.base = addr;
+    else if(addr < cache.base){
+        entries.insert(entries.begin(), cache.base - addr, DecodeEntry());
+        cache.text.insert(0, (cache.base - addr) * 2, '\0');
+        cache.base = addr;
+    }
+    if(entries.size() < end - cache.base){
+        entries.resize(end - cache.base, DecodeEntry());
+        cache.text.resize((end - cache.base) * 2, '\0');
+    }
+    size_t first = addr - cache.base;   // index of addr in cache
+    if(cache.text.compare(first * 2, chars, record, 9, chars) != 0){
+        for(size_t a = (first >= 3 ? first - 3 : 0); a < end - cache.base; a++)
+            if(a >= first || a + (entries[a].avail + 1) / 2 > first)
+                entries[a].avail = 0;
+        cache.text.replace(first * 2, chars, record, 9, chars);
+    }
+    return true;
+}
+/**
+ *  decode_entry()
+ *  - Literals are never decoded as instructions. Otherwise format 2 is
+ *    checked first, then format 4 & format 3.
+ *  @param: text record, index of object code in record, its address
+ *  @return: decisions w/ format, mnemonic & flags filled in
+ */
+DecodeEntry Disassembler::decode_entry(const string &record, int index, unsigned int addr){
+    DecodeEntry d = DecodeEntry();
+    if(is_in_littab(addr))
+        return d;
+    string obj_code;
+    if(is_format_2(record.substr(index,2))){
+        d.format = 2;
+        d.mnemonic = find_mnemonic(record.substr(index,2),2);
+        return d;
+    }
+    if(is_format_4(record.substr(index,8))){
+        d.format = 4;
+        obj_code = record.substr(index,8);
+    }
+    else if(is_format_3(record.substr(index,6))){
+        d.format = 3;
+        obj_code = record.substr(index,6);
+    }
+    else
+        return d;
+    d.mnemonic = find_mnemonic(record.substr(index,2),d.format);
+    vector<int> vec;
+    get_addressing_mode(obj_code, vec);
+    for(int i = 0; i < 5; i++)
+        d.flags = (d.flags << 1) | vec[i];
+    return d;
+}
+/**
+ *  find_symbols()
+ *  - Symbol addresses are converted once per symtab. When symtab order is
+ *    also address order, symbols in range are found by binary search.
+ *  @param: lowest & highest address, vector to add symtab keys to
+ *  @return: none
+ */
+void Disassembler::find_symbols(int from, int to, vector<string> &addrs){
+    if(!sym_addrs_built){
+        map<string,string>::const_iterator it;
+        for(it = scope->symtab.begin(); it != scope->symtab.end(); it++)
+            sym_addrs.push_back(make_pair((int)hex_to_int(it->first), it->first));
+        sym_addrs_sorted = true;
+        for(size_t i = 1; i < sym_addrs.size(); i++)
+            if(sym_addrs[i].first < sym_addrs[i-1].first)
+                sym_addrs_sorted = false;
+        sym_addrs_built = true;
+    }
+    if(!sym_addrs_sorted){
+        for(size_t i = 0; i < sym_addrs.size(); i++)
+            if(sym_addrs[i].first >= from && sym_addrs[i].first <= to)
+                addrs.push_back(sym_addrs[i].second);
+        return;
+    }
+    vector<pair<int,string>>::iterator lo = lower_bound(sym_addrs.begin(),
+        sym_addrs.end(), make_pair(from, string()));
+    for(; lo != sym_addrs.end() && lo->first <= to; lo++)
+        addrs.push_back(lo->second);
 }
 /**
  *  is_format_2()
@@ -387,11 +1176,11 @@ void Disassembler::read_text_record(){
  *  @return: true if mnemonic op found, false otherwise
  */
 bool Disassembler::is_format_2(string opcode){
-    map<string,string>::iterator it;
+    map<string,string>::const_iterator it;
     int x = hex_to_int(opcode);    //return decimal value of opcode
     bitset<8> b(x);     // converts decimal to binary, makes call to bitset
-    it = mnemonic_op.find(b.to_string());
-    if (it == mnemonic_op.end())
+    it = mnemonic_op->find(b.to_string());
+    if (it == mnemonic_op->end())
         return false;
     return true;
 }
@@ -402,7 +1191,7 @@ bool Disassembler::is_format_2(string opcode){
  *  @return: true if format 4, false otherwise
  */
 bool Disassembler::is_format_4(string obj_code){
-    if(obj_code.length() < 8)
+    if(obj_code.length() < 8 || get_mnemonic_op(obj_code.substr(0,2),4) == "")
         return false;
     unsigned int x = hex_to_int(obj_code); 
     bitset<32> b(x);     // converts decimal to binary, makes call to bitset
@@ -418,7 +1207,7 @@ bool Disassembler::is_format_4(string obj_code){
  *  @return: true if format 3, false otherwise
  */
 bool Disassembler::is_format_3(string obj_code){
-    if(obj_code.length() < 6)
+    if(obj_code.length() < 6 || get_mnemonic_op(obj_code.substr(0,2),3) == "")
         return false;
     unsigned int x = hex_to_int(obj_code); 
     bitset<24> b(x);     // converts decimal to binary, makes call to bitset
@@ -431,36 +1220,58 @@ bool Disassembler::is_format_3(string obj_code){
  *  get_symbol()
  *  - Iterate through symtab to find symbol at a given address.
  *  - Int address converted to hex then formated for proper searching.
+ *  - Result is kept in decode cache for addresses of text decoded so far.
  *  @param: int memory address
  *  @return: symbol if found, empty string otherwise
  */
 string Disassembler::get_symbol(unsigned int addr){
-    map<string,string>::iterator it;    // iterate through sytab
+    const static string no_symbol = "";
+    DecodeEntry *cached = NULL;
+    if(addr >= cache.base && addr - cache.base < cache.entries.size())
+        cached = &cache.entries[addr - cache.base];
+    if(cached && cached->label)
+        return *cached->label;
+    map<string,string>::const_iterator it;  // iterate through sytab
     string symbol = decimal_to_hex(addr);
     to_uppercase(symbol);       //capitalize alphabetical chars in hex addr
     // adds 0s to front of hex addr until num bits needed is reached.
     add_offset_bits(6,symbol);      // 6 bits needed for searching symtab
     // search symtab for 
-    it = symtab.find(symbol);
-    if (it != symtab.end())
-        return it->second;
-    return "";
+    it = scope->symtab.find(symbol);
+    const string *label = (it != scope->symtab.end() ? &it->second : &no_symbol);
+    if(cached)
+        cached->label = label;
+    return *label;
 }
 /**
  *  get_mnemonic_op()
  *  - Converts a byte of hex to binary to extract mnemonic operation.
  *  - Given instruction format, 2 extra bits are added to binary number.
  *  @param: byte from object code, instruction format
- *  @return: mnemonic op from hashtable.
+ *  @return: mnemonic op from hashtable, empty string if not an opcode.
  */
-string Disassembler::get_mnemonic_op(string byte, int format){
+string Disassembler::get_mnemonic_op(string byte, int format) const{
+    const string *mnemonic = find_mnemonic(byte, format);
+    return (mnemonic ? *mnemonic : "");
+}
+/**
+ *  find_mnemonic()
+ *  @param: byte from object code, instruction format
+ *  @return: mnemonic op in hashtable, null if not an opcode.
+ */
+const string *Disassembler::find_mnemonic(string byte, int format) const{
     unsigned int x = hex_to_int(byte);  // hex string to binary
     bitset<8> b(x);                     // converts decimal to binary, makes call to bitset
     string temp = b.to_string();
     // setting final 2 bits to 0. Opcode = 6 bits + "00".
-    if(format >= 3)
-        temp[6] = '0'; temp[7] = '0';
-    return mnemonic_op.find(temp)->second;
+    if(format >= 3){
+        temp[6] = '0';
+        temp[7] = '0';
+    }
+    map<string,string>::const_iterator it = mnemonic_op->find(temp);
+    if(it == mnemonic_op->end())
+        return NULL;
+    return &it->second;
 }
 /**
  *  get_addressing_mode()
@@ -491,22 +1302,21 @@ void Disassembler::get_addressing_mode(string obj_code, vector<int> &vec){
  *  write_to_output():
  *  - Properly formats assembly instruction using object code.
  *  - Checks all addressing mode types and makes updates according to mode.
- *  - Assembly instruction formated then written to file.
- *  @param: current address, object code, mnemonic op
+ *  - Assembly instruction & target address passed on as a Statement.
+ *  @param: current address, object code, mnemonic op, n i x b p flag bits
  *  @return: none 
  */
-void Disassembler::write_to_output(unsigned int cur_addr,string obj_code,string mnemonic){
+void Disassembler::write_to_output(unsigned int cur_addr,string obj_code,string mnemonic,
+                                   unsigned char flags){
     // determine object code format using object code length
     string format = (obj_code.length() % 8 == 0 ? "+" : "");
     // excluding the first 3 nibbles in object code will leave disp/address.
     string operand_addr = obj_code.substr(3,obj_code.size()-3);
-    string operand_mode = "";
     string operand; // name of operand
     string max_hex; //holds max hex value for given number of nibbles
-    vector<int> vec;
-    int index = 0;  // temp index var
-    //checking flagbits to determine TA addressing mode.
-    get_addressing_mode(obj_code, vec);
+    int vec[5];     // flagbits [n,i,x,b,p] determine TA addressing mode.
+    for(int i = 0; i < 5; i++)
+        vec[i] = (flags >> (4 - i)) & 1;
     // getting symbol from symtab.
     string symbol = get_symbol(cur_addr);
     // converting object code from hex to int
@@ -518,7 +1328,7 @@ void Disassembler::write_to_output(unsigned int cur_addr,string obj_code,string
     if(b.to_string().substr(0,1) == "1"){
         max_hex="";
         //concatenating 'F's to empty string
-        for(int i = 0; i < operand_addr.length();i++){
+        for(size_t i = 0; i < operand_addr.length();i++){
             max_hex += 'F';
         }
         // converting hex to integer
@@ -558,66 +1368,57 @@ void Disassembler::write_to_output(unsigned int cur_addr,string obj_code,string
     //getting operand from symtab.
     else
         operand = get_symbol(x);
+    bool operand_is_name = false;   // operand names a constant in littab
     // check literal table if no operand found
     if(operand == ""){
         // retrive literal from target address
         tuple<string,string,int> mytuple = get_literal(x);
         string name = get<0>(mytuple);
         string lit_const = get<1>(mytuple);
-        unsigned int length = get<2>(mytuple);
         // remove spaces from name. Literals have no name so they are all space.
         // check if literal name length is 0
         if(!name.length()){
             operand = lit_const;    // operand is literal
             literals.push_back(x);
         }
-        else
-            operand = name+"\t";         // else, operand is name
-    }
-    // converting current address from int, to hex string
-    string curr_address_hex = decimal_to_hex(cur_addr);
-    //capitalize alphabetical chars in hex address
-    to_uppercase(curr_address_hex);
-    // adds 0s to front of hex address number of bits needed is reached
-    add_offset_bits(4, curr_address_hex);
+        else{
+            operand = name;         // else, operand is name
+            operand_is_name = true;
+        }
+    }
+    Statement s(Statement::INSTRUCTION);
+    s.address = cur_addr;
+    s.has_address = true;
+    s.label = symbol;
+    s.mnemonic = format + mnemonic;
+    s.operand = operand;
+    s.operand_is_name = operand_is_name;
     //determine TA addressing mode
     //if indirect addressing mode: (n=1, i=0)
     if(vec[0] && !vec[1])
-        operand_mode = '@';
+        s.mode = '@';
     //if immediate addressing mode: (n=0, i=1)
     if(!vec[0] && vec[1])
-        operand_mode = '#';
+        s.mode = '#';
     //check index addressing mode
-    if(vec[2]){
-        index = 0;
-        // loop through string until space found.
-        while(index >= 0 && operand.length()){
-            if(operand[index] != ' '){
-                index++;
-            }
-            else{
-                operand = operand.substr(0,index);
-                break;
-            }
-        }
-        operand += ",X";
-    }
-    int offset = 10 - operand.length();
-    while(offset > 0){
-        operand += ' ';
-        offset--;
-    }
-    // logging statements to output file
-    ofs <<curr_address_hex<<"\t";
-    if(symbol == "")
-        ofs<<"\t";
-    if(symbol.length() > 4)
-        symbol = symbol + '\t';
-    ofs << symbol<<format+mnemonic <<"\t";
-    ofs << operand_mode+operand<<"\t"<<obj_code<<endl;
-    // logging base statement to output file
+    s.indexed = vec[2];
+    s.obj_code = obj_code;
+    s.relocated = relocate_code(cur_addr, s.obj_code);
+    s.format = (format == "+" ? 4 : 3);
+    s.target = x;
+    // pc & base relative targets move w/ the section, as do addresses
+    // named by a modification record. Other targets are absolute.
+    if(vec[3] || vec[4] || s.relocated)
+        s.target += load_delta;
+    emit(s);
+    // base statement follows LDB
     if(mnemonic == "LDB"){
-        ofs <<"\t\tBASE\t"<< operand<<endl;
+        Statement b(Statement::BASE);
+        b.mnemonic = "BASE";
+        b.operand = operand;
+        b.operand_is_name = operand_is_name;
+        b.indexed = vec[2];
+        emit(b);
         base = operand_addr;
     }
     if(mnemonic == "LDX"){
@@ -628,7 +1429,8 @@ void Disassembler::write_to_output(unsigned int cur_addr,string obj_code,string
  * get_literal():
  *  - Gets value from littab if given memory address is in the map.
  *  @param: decimal memory address
- *  @return: tuple containing literal information <name, lit_const, length> 
+ *  @return: tuple containing literal information <name, lit_const, length>,
+ *           empty tuple if address is not in littab.
  */
 tuple<string,string,unsigned int> Disassembler::get_literal(unsigned int addr){
     // converting decimal address to hex
@@ -637,7 +1439,10 @@ tuple<string,string,unsigned int> Disassembler::get_literal(unsigned int addr){
     to_uppercase(temp);
     // adding 0's to front of hex address until bits needed is reached
     add_offset_bits(6,temp);        // 6 bits needed for searching symtab
-    return littab[temp];
+    map<string, tuple <string,string,unsigned int>>::const_iterator it = scope->littab.find(temp);
+    if(it == scope->littab.end())
+        return tuple<string,string,unsigned int>("","",0);
+    return it->second;
 }
 /**
  * is_in_littab():
@@ -648,25 +1453,37 @@ tuple<string,string,unsigned int> Disassembler::get_literal(unsigned int addr){
  */
 bool Disassembler::is_in_littab(unsigned int addr){
     // littab iterator
-    map<string, tuple <string,string,unsigned int>>::iterator it;         
+    map<string, tuple <string,string,unsigned int>>::const_iterator it;
     string temp = decimal_to_hex(addr);
     //uppercase alphabetical chars only
     to_uppercase(temp);
     //adding extra 0's to hex address
     add_offset_bits(6,temp);        // 6 nibbles needed for searching littab
-    it = littab.find(temp);
-    if(it != littab.end())
+    it = scope->littab.find(temp);
+    if(it != scope->littab.end())
         return true;
     return false;
 }
+unsigned long long Disassembler::get_cache_hits() const{
+    return cache_hits;
+}
+unsigned long long Disassembler::get_cache_misses() const{
+    return cache_misses;
+}
+unsigned long long Disassembler::get_range_hits() const{
+    return range_hits;
+}
+unsigned long long Disassembler::get_range_misses() const{
+    return range_misses;
+}
 /**
  * hex_to_int():
  *  - Uses stringstream object to convert hex string to decimal integer.
  *  @param: hex string
  *  @return: integer value  
  */
-unsigned int Disassembler::hex_to_int(string hex_address){
-    unsigned int x; 
+unsigned int Disassembler::hex_to_int(string hex_address) const{
+    unsigned int x = 0; 
     stringstream ss;    // stringstream object
     ss << hex << hex_address;    // reading hex into integer
     ss >> x;            // storing int value into x.
@@ -681,7 +1498,7 @@ unsigned int Disassembler::hex_to_int(string hex_address){
  */
 void Disassembler::to_uppercase(string &hex_addr){
     // make chars uppercase if they are lowercase alphabetical chars.
-    for(int i = 0; i < hex_addr.length(); i++){
+    for(size_t i = 0; i < hex_addr.length(); i++){
         if(hex_addr[i] >=97)
             hex_addr[i] -= 32;
     }
@@ -720,10 +1537,52 @@ void Disassembler::close_file(){
 }
 /**
  * read_end_record():
- *  - Prints end statement to output file.
+ *  - Prints end statement to output file, if one was opened.
  *  @param: none
  *  @return: none  
  */
 void Disassembler::read_end_record(){
-    ofs << "\t\tEND\t"<<prog_name<<endl;
+    Statement s(Statement::END);
+    s.mnemonic = "END";
+    s.operand = prog_name;
+    emit(s);
+    if(ofs.is_open())
+        ofs << take_output();
+}
+/**
+ * emit():
+ *  - Queues decoded statement for renderers.
+ *  - Relocated sections list statements at their loaded address.
+ *  @param: statement
+ *  @return: none  
+ */
+void Disassembler::emit(Statement s){
+    s.section = prog_name;
+    if(s.has_address)
+        s.address += load_delta;
+    statements.push_back(s);
+}
+/**
+ * take_statements():
+ *  - Hands statements decoded so far to the caller and clears the queue.
+ *  @param: vector to store statements in
+ *  @return: none  
+ */
+void Disassembler::take_statements(vector<Statement> &v){
+    v.clear();
+    v.swap(statements);
+}
+/**
+ * take_output():
+ *  - Renders statements decoded so far as listing & clears the queue.
+ *  @param: none
+ *  @return: rendered assembly statements
+ */
+string Disassembler::take_output(){
+    ListingRenderer listing;
+    string s;
+    for(size_t i = 0; i < statements.size(); i++)
+        listing.render(statements[i], s);
+    statements.clear();
+    return s;
 }
\ No newline at end of file
@@ -9,19 +9,96 @@
  *      - [Omar Martinez(REDID:818749029)]
  *      - [Nick Riazanov(REDID:819099418)]
  */
+#ifndef DISASSEMBLER_H
+#define DISASSEMBLER_H
+
 #include <string>
 #include <map>
 #include <vector>
 #include <fstream>
 #include <tuple>
+#include <memory>
+#include "Statement.h"
 
 using namespace std;
 
+// symbols & literals belonging to one control section
+struct SymbolScope
+{
+    // [key,value] = [address, symbol]
+    map<string, string> symtab;
+    // [key,value] = [address, (Lit_Name,Lit_Const, size)]
+    map<string, tuple <string,string,unsigned int>> littab;
+};
+
+// decode decisions at one address, reused until its text or the tables change
+struct DecodeEntry
+{
+    // mnemonic of instruction, null for constants
+    const string *mnemonic;
+    // symbol at address, null until looked up
+    const string *label;
+    // hex chars left in record when decoded (at most 8), 0 if not decoded
+    unsigned char avail;
+    // last char of record when avail is odd, it has no byte of its own
+    char tail;
+    // 2, 3 or 4 for instructions, 0 for constants
+    unsigned char format;
+    // n i x b p bits of format 3 & 4 instructions, n is the highest
+    unsigned char flags;
+};
+
+// decode state a text record started in when read_range() resolved it
+struct RecordState
+{
+    // pc, base & x register
+    int pc;
+    string base;
+    int x_reg;
+    // index of first statement of record in DecodeCache::statements
+    size_t first;
+};
+
+// statement w/ address resolved by read_range(), indexed by address
+struct RangeEntry
+{
+    unsigned int address;
+    // statements handed over w/ it: the ones w/o address (LTORG) before it,
+    // up to & including itself
+    size_t first, last;
+};
+
+// decode decisions of one control section, kept between decode passes
+struct DecodeCache
+{
+    // address of first entry
+    unsigned int base;
+    // decode decisions & symbols indexed by address - base, from the lowest
+    // to the highest address decoded
+    vector<DecodeEntry> entries;
+    // hex chars of text decoded at each half byte from base
+    string text;
+    // statements of the text records read_range() resolved, in deck order,
+    // & the state each record started in
+    vector<Statement> statements;
+    vector<RecordState> records;
+    // statements w/ address, sorted by address. in_order is true if that
+    // is deck order as well.
+    vector<RangeEntry> by_address;
+    bool in_order;
+
+    DecodeCache() : base(0), in_order(true){}
+    // true if nothing has been decoded into the cache yet
+    bool empty() const{ return entries.empty() && text.empty() && records.empty(); }
+};
+
 class Disassembler
 {
 private:
     // write to file w/o overwritting
     ofstream ofs;
+    // statements decoded since last call to take_statements()
+    vector<Statement> statements;
     // vector containing object code
     vector<string> object_code;
     // holds all address for literals used
@@ -34,28 +111,88 @@ private:
     string prog_length;
     // program counter. Int can be converted to hex.
     int pc;
+    // x register
+    int x_reg;
     // holds register char in index based on reg value
     vector<char> registers;
     // base register
     string base;
-    // hashmap that holds mnemonic keys and op value
-    map<string, string> mnemonic_op;
-    // mapping symbol to address. [key,value] = [address, symbol]
-    map<string, string> symtab;
-    // mappng literals to their address.
-    //[key,value] = [address, (Lit_Name,Lit_Const, size)]
-    map<string, tuple <string,string,unsigned int>> littab;         
+    // hashmap that holds mnemonic keys and op value. Shared read-only by
+    // copies, so cached mnemonics stay valid after the copy is gone.
+    shared_ptr<const map<string, string>> mnemonic_op;
+    // symbols & literals added by parse_symbol() & parse_literal()
+    SymbolScope parsed;
+    // symbol & literal tables of each control section, in .sym file order.
+    // Shared read-only by copies decoding other sections.
+    shared_ptr<const vector<SymbolScope>> scopes;
+    // tables of selected control section, in scopes or parsed
+    const SymbolScope *scope;
+    // object code bytes loaded from text records, indexed by address
+    vector<unsigned char> image;
+    // modification records sorted by address. (address << 8 | sign | half bytes)
+    vector<unsigned int> relocations;
+    // decode cache of selected control section
+    DecodeCache cache;
+    // caches of other control sections by index, kept while another one is
+    // selected. Sections never decoded have no entry.
+    map<unsigned int, DecodeCache> parked_caches;
+    // control section selected by use_scope()
+    unsigned int cache_section;
+    // decode decisions reused & made, for stats
+    unsigned long long cache_hits, cache_misses;
+    // statements read_range() handed over from cache & resolved, for stats
+    unsigned long long range_hits, range_misses;
+    // symtab addresses in symtab order, built on first RESB search
+    vector<pair<int,string>> sym_addrs;
+    bool sym_addrs_built, sym_addrs_sorted;
+    // true once modification records have been applied to image
+    bool relocating;
+    // bytes section was moved by when relocated, added to listed addresses
+    unsigned int load_delta;
+
+    // parses header record into name, start addr & prog length
+    void parse_header(string header);
+
+    // queues decoded statement for renderers
+    void emit(Statement s);
+
+    // makes selected scope a private copy before rows are added to it
+    void edit_scope();
+
+    // drops decode caches & symbol index after symtab or littab changed
+    void clear_decode_cache();
+
+    // resolves text records of object_code not resolved by read_range() yet
+    void resolve_records();
+
+    // invalidates cached decisions where record differs from text decoded at
+    // address before. False if record is not cached.
+    bool check_decoded_text(unsigned int addr, const string &record);
+
+    // decides format, mnemonic & flags of object code at index of record
+    DecodeEntry decode_entry(const string &record, int index, unsigned int addr);
+
+    // symbols in symtab between two addresses, in symtab order
+    void find_symbols(int from, int to, vector<string> &addrs);
 public:
     // overloaded constructor
     Disassembler(const string m[], const string o[]);
     //default constructor
     Disassembler();
+    // shares decode tables & symbol scopes, not files or decode state
+    Disassembler(const Disassembler &other);
     //~Disassembler();
     // reading in .obj file and storing into vector
     bool read_obj_file(string filename);
 
     // reading in .sym file and mapping symbol to literal.
-    bool read_sym_file(string filename);
+    bool read_sym_file(string filename, unsigned int workers = 1);
+
+    // reading object deck from stream and storing into vector
+    void read_obj_stream(istream &in);
+
+    // reading symbol file from stream, tables are parsed on worker threads.
+    void read_sym_stream(istream &in, unsigned int workers = 1);
 
     // reads first two bytes of obj code to determine format.
     bool is_format_2(string opcode);  
@@ -69,12 +206,72 @@ public:
     // checks if address is a constant in littab
     bool is_in_littab(unsigned int addr);
 
+    // opens file which logs SIC/XE source statements
+    bool open_file(string filename);
+
     // reads Header row and extracts name, start addr & prog length
     void read_header_row();
+    void read_header_row(string header);
+
+    // reads Header row of a control section after the first
+    void read_csect_row(string header);
+
+    // reads Define record and prints EXTDEF statement
+    void read_define_record(string record);
+
+    // reads Refer record and prints EXTREF statement
+    void read_refer_record(string record);
+
+    // selects symbol & literal tables of given control section
+    void use_scope(unsigned int section);
+
+    // symbol & literal tables of control section, null if .sym file has none
+    const SymbolScope *get_scope(unsigned int section) const;
+
+    // swaps decode cache kept for control section w/ the selected cache of
+    // other, which shares the symbol scopes. Lends it to a copy decoding the
+    // section and takes it back afterwards.
+    void swap_decode_cache(unsigned int section, Disassembler &other);
+
+    // object code bytes loaded from text records, indexed by address
+    const vector<unsigned char> &get_image() const;
+
+    // register names, indexed by register number
+    const vector<char> &get_registers() const;
+
+    // splits header record into program name, start address & length
+    static void split_header(string header, string &name, string &start, string &length);
+
+    // copies object code bytes of text record into image
+    void load_text_record(string record);
+
+    // reads Modification record into relocation index
+    void read_modification_record(string record);
+
+    // applies modification records to image for section moved by delta
+    // bytes, i.e. load address - start address
+    void relocate(unsigned int delta);
+
+    // replaces object code at address w/ relocated code. True if relocated.
+    bool relocate_code(unsigned int addr, string &obj_code);
 
     // reads object code in text records.
     void read_text_record();
 
+    // reads one record. next_record is the record following it in the deck.
+    void read_text_record(string record, string next_record);
+
+    // decodes text records like read_text_record() and hands over the
+    // statements w/ address in [from, to). Statements are resolved once,
+    // repeated queries read them from the decode cache.
+    void read_range(unsigned int from, unsigned int to, vector<Statement> &v);
+
+    // hands over statements decoded so far and clears the queue
+    void take_statements(vector<Statement> &v);
+
+    // returns statements rendered as listing and clears the queue
+    string take_output();
+
     // prints end record statement
     void read_end_record();
 
@@ -84,6 +281,14 @@ public:
     // closes file which logs SIC/XE source statements
     void close_file();                 
 
+    // decode decisions reused from & added to decode cache
+    unsigned long long get_cache_hits() const;
+    unsigned long long get_cache_misses() const;
+
+    // statements read_range() handed over w/o resolving any & resolved
+    unsigned long long get_range_hits() const;
+    unsigned long long get_range_misses() const;
+
     // converts decimal integer into hexidecimal string 
     string decimal_to_hex(unsigned int decimal);
 
@@ -91,26 +296,34 @@ public:
     string get_symbol(unsigned int addr);
 
     // converting hex string to decimal
-    unsigned int hex_to_int(string hex_address);
+    unsigned int hex_to_int(string hex_address) const;
 
     // adds 0s to front of hex address number of bits needed is reached.
     void add_offset_bits(int num_bits, string &hex_addr);
 
-    // writes format 2,3, & 4 statements to file
-    void write_to_output(unsigned int cur_addr,string obj_code,string mnemonic);
+    // writes format 3 & 4 statements to file, flags as in DecodeEntry
+    void write_to_output(unsigned int cur_addr,string obj_code,string mnemonic,
+                         unsigned char flags);
 
     // get literal at current address.
     tuple<string,string,unsigned int> get_literal(unsigned int addr);
 
     // parse through littab to get all information
     void parse_literal(string littab_row);
+    static void split_literal(const string &littab_row, string &addr,
+                              tuple<string,string,unsigned int> &lit);
 
     // parse through symtab to get all information
     void parse_symbol(string symtab_row);
+    static void split_symbol(const string &symtab_row, string &addr, string &name);
 
     // reads first byte of object code and returns mnemonic operation
-    string get_mnemonic_op(string byte,int format);
+    string get_mnemonic_op(string byte,int format) const;
+    // same, null if not an opcode
+    const string *find_mnemonic(string byte,int format) const;
 
     // get operande addressing mode from object code.
     void get_addressing_mode(string obj_code, vector<int> &vec);
-};
\ No newline at end of file
+};
+
+#endif
@@ -0,0 +1,428 @@
+/**
+ *  FlowGraph.cpp
+ *  - A block starts at the first instruction of a section, at the target of
+ *    J, JEQ, JGT, JLT & JSUB, after any of those & RSUB, and after a gap
+ *    left by constants or reserved bytes.
+ *  - Targets are found through an array indexed by address, so building a
+ *    section takes time linear in its number of instructions.
+ *  - Indirect & indexed jumps, and targets outside the section, have no
+ *    edge; their block is marked unresolved.
+ *  - Functions start at the section entry and at JSUB targets. A block is
+ *    owned by the first function reaching it w/o entering another function.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include "FlowGraph.h"
+#include "Renderer.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// address index may be this many times larger than the number of instructions
+const static size_t DENSE_FACTOR = 16;
+const static size_t DENSE_SLACK = 1 << 16;
+
+const static char *EDGE_NAMES[] = { "fallthrough", "taken", "jump" };
+
+// orders instructions & labels by address
+static bool by_address(const FlowInstruction &a, const FlowInstruction &b){
+    return a.address < b.address;
+}
+static bool label_by_address(const pair<unsigned int, string> &a,
+                             const pair<unsigned int, string> &b){
+    return a.first < b.first;
+}
+/**
+ *  add()
+ *  - Section name is taken from the START or CSECT statement.
+ *  @param: decoded statement
+ *  @return: none
+ */
+void SectionFlow::add(const Statement &s){
+    if(name == "")
+        name = s.section;
+    if(s.kind != Statement::INSTRUCTION && s.kind != Statement::REGISTER)
+        return;
+    // object code cut short by end of record takes no space
+    if(s.obj_code.length() < 2)
+        return;
+    FlowInstruction ins;
+    ins.address = s.address;
+    ins.target = s.target;
+    ins.length = s.obj_code.length() / 2;
+    ins.flow = FLOW_NEXT;
+    ins.direct = (s.mode != '@' && !s.indexed);
+    if(s.kind == Statement::INSTRUCTION){
+        string op = s.mnemonic;
+        if(op != "" && op[0] == '+')
+            op.erase(0, 1);
+        if(op == "J")
+            ins.flow = FLOW_JUMP;
+        else if(op == "JEQ" || op == "JGT" || op == "JLT")
+            ins.flow = FLOW_BRANCH;
+        else if(op == "JSUB")
+            ins.flow = FLOW_CALL;
+        else if(op == "RSUB")
+            ins.flow = FLOW_RETURN;
+    }
+    if(s.label != "")
+        labels.push_back(make_pair(s.address, s.label));
+    code.push_back(ins);
+}
+/**
+ *  find_instruction()
+ *  @param: address
+ *  @return: index of instruction starting at address, -1 if none
+ */
+int SectionFlow::find_instruction(unsigned int addr) const{
+    if(!index.empty()){
+        if(addr < lo || addr - lo >= index.size())
+            return -1;
+        return index[addr - lo];
+    }
+    FlowInstruction key;
+    key.address = addr;
+    vector<FlowInstruction>::const_iterator it =
+        lower_bound(code.begin(), code.end(), key, by_address);
+    if(it == code.end() || it->address != addr)
+        return -1;
+    return it - code.begin();
+}
+/**
+ *  build()
+ *  - Text records may come in any order, so instructions are sorted by
+ *    address first. Instructions overlapping an earlier one are dropped.
+ *  @param: none
+ *  @return: none
+ */
+void SectionFlow::build(){
+    if(!is_sorted(code.begin(), code.end(), by_address)){
+        stable_sort(code.begin(), code.end(), by_address);
+        stable_sort(labels.begin(), labels.end(), label_by_address);
+    }
+    size_t n = 0;
+    for(size_t i = 0; i < code.size(); i++){
+        if(n && code[i].address < (size_t)code[n-1].address + code[n-1].length)
+            continue;
+        code[n++] = code[i];
+    }
+    code.resize(n);
+    blocks.clear();
+    succ_offset.assign(1, 0);
+    succ.clear();
+    succ_kind.clear();
+    functions.clear();
+    call_offset.assign(1, 0);
+    callee.clear();
+    if(code.empty())
+        return;
+    lo = code.front().address;
+    size_t span = (size_t)code.back().address + code.back().length - lo;
+    index.clear();
+    if(span <= DENSE_FACTOR * code.size() + DENSE_SLACK){
+        index.assign(span, -1);
+        for(size_t i = 0; i < code.size(); i++)
+            index[code[i].address - lo] = i;
+    }
+    build_blocks();
+    build_calls();
+    // lookup tables are only needed while building
+    vector<int>().swap(index);
+    vector<unsigned int>().swap(block_of);
+}
+/**
+ *  build_blocks()
+ *  - Marks leaders, groups instructions into blocks, then adds successors
+ *    of each block in block order so the adjacency arrays fill in one pass.
+ *  - Jumps & branches to a block at or before their own are loop edges.
+ *  @param: none
+ *  @return: none
+ */
+void SectionFlow::build_blocks(){
+    size_t n = code.size();
+    vector<char> leader(n, 0);
+    leader[0] = 1;
+    for(size_t i = 0; i < n; i++){
+        const FlowInstruction &ins = code[i];
+        bool contiguous = (i+1 < n && (size_t)ins.address + ins.length == code[i+1].address);
+        if(i+1 < n && (ins.flow != FLOW_NEXT || !contiguous))
+            leader[i+1] = 1;
+        if(ins.flow != FLOW_NEXT && ins.flow != FLOW_RETURN && ins.direct){
+            int j = find_instruction(ins.target);
+            if(j >= 0)
+                leader[j] = 1;
+        }
+    }
+    block_of.resize(n);
+    for(size_t i = 0; i < n; i++){
+        if(leader[i]){
+            Block b;
+            b.start = code[i].address;
+            b.first = i;
+            b.count = 0;
+            b.function = -1;
+            b.unresolved = b.returns = b.loop_head = false;
+            blocks.push_back(b);
+        }
+        blocks.back().count++;
+        blocks.back().end = code[i].address + code[i].length;
+        block_of[i] = blocks.size() - 1;
+    }
+    // labels & block starts are both sorted by address
+    size_t l = 0;
+    for(size_t b = 0; b < blocks.size(); b++){
+        while(l < labels.size() && labels[l].first < blocks[b].start)
+            l++;
+        if(l < labels.size() && labels[l].first == blocks[b].start)
+            blocks[b].label = labels[l].second;
+    }
+    for(size_t b = 0; b < blocks.size(); b++){
+        const FlowInstruction &last = code[blocks[b].first + blocks[b].count - 1];
+        int target = -1;    // block jumped or branched to
+        if(last.flow == FLOW_JUMP || last.flow == FLOW_BRANCH){
+            int j = (last.direct ? find_instruction(last.target) : -1);
+            if(j >= 0)
+                target = block_of[j];
+            else
+                blocks[b].unresolved = true;
+        }
+        if(target >= 0){
+            succ.push_back(target);
+            succ_kind.push_back(last.flow == FLOW_JUMP ? EDGE_JUMP : EDGE_TAKEN);
+            if(blocks[target].start <= blocks[b].start)
+                blocks[target].loop_head = true;
+        }
+        bool falls = (last.flow != FLOW_JUMP && last.flow != FLOW_RETURN);
+        if(falls && b+1 < blocks.size() && blocks[b+1].start == blocks[b].end){
+            succ.push_back(b+1);
+            succ_kind.push_back(EDGE_FALLTHROUGH);
+        }
+        blocks[b].returns = (last.flow == FLOW_RETURN);
+        succ_offset.push_back(succ.size());
+    }
+}
+/**
+ *  build_calls()
+ *  - Each block is visited once while assigning owners, and calls are
+ *    bucketed by caller, so the call graph is built in linear time.
+ *  - A callee is listed once per caller, in order of first call.
+ *  @param: none
+ *  @return: none
+ */
+void SectionFlow::build_calls(){
+    size_t nb = blocks.size();
+    vector<int> entered(nb, -1);    // function entered at block
+    vector<pair<unsigned int, unsigned int>> calls;   // (calling block, callee)
+    Function entry;
+    entry.entry = 0;
+    functions.push_back(entry);
+    entered[0] = 0;
+    for(size_t b = 0; b < nb; b++){
+        const FlowInstruction &last = code[blocks[b].first + blocks[b].count - 1];
+        if(last.flow != FLOW_CALL || !last.direct)
+            continue;
+        int j = find_instruction(last.target);
+        if(j < 0)
+            continue;
+        unsigned int t = block_of[j];
+        if(entered[t] < 0){
+            Function f;
+            f.entry = t;
+            entered[t] = functions.size();
+            functions.push_back(f);
+        }
+        calls.push_back(make_pair(b, entered[t]));
+    }
+    size_t nf = functions.size();
+    vector<unsigned int> stack;
+    for(size_t f = 0; f < nf; f++){
+        Block &e = blocks[functions[f].entry];
+        functions[f].name = (e.label != "" ? e.label : "sub_" + to_hex(e.start, 4));
+        e.function = f;
+        stack.push_back(functions[f].entry);
+        while(!stack.empty()){
+            unsigned int b = stack.back();
+            stack.pop_back();
+            for(unsigned int k = succ_offset[b]; k < succ_offset[b+1]; k++){
+                unsigned int t = succ[k];
+                if(blocks[t].function < 0 && entered[t] < 0){
+                    blocks[t].function = f;
+                    stack.push_back(t);
+                }
+            }
+        }
+    }
+    // bucket callees by calling function
+    call_offset.assign(nf + 1, 0);
+    for(size_t c = 0; c < calls.size(); c++){
+        int caller = blocks[calls[c].first].function;
+        if(caller >= 0)
+            call_offset[caller + 1]++;
+    }
+    for(size_t f = 0; f < nf; f++)
+        call_offset[f + 1] += call_offset[f];
+    vector<unsigned int> pos(call_offset.begin(), call_offset.end() - 1);
+    callee.resize(call_offset[nf]);
+    for(size_t c = 0; c < calls.size(); c++){
+        int caller = blocks[calls[c].first].function;
+        if(caller >= 0)
+            callee[pos[caller]++] = calls[c].second;
+    }
+    // drop repeated callees
+    vector<int> seen(nf, -1);
+    size_t out = 0;
+    for(size_t f = 0; f < nf; f++){
+        unsigned int begin = call_offset[f], end = call_offset[f + 1];
+        call_offset[f] = out;
+        for(unsigned int k = begin; k < end; k++){
+            if(seen[callee[k]] != (int)f){
+                seen[callee[k]] = f;
+                callee[out++] = callee[k];
+            }
+        }
+    }
+    call_offset[nf] = out;
+    callee.resize(out);
+}
+/**
+ *  add_section()
+ *  @param: built section flow, left empty
+ *  @return: none
+ */
+void FlowGraph::add_section(SectionFlow &flow){
+    sections.push_back(SectionFlow());
+    swap(sections.back(), flow);
+}
+/**
+ *  dot_escape()
+ *  @param: string
+ *  @return: string escaped for use inside a quoted DOT string
+ */
+static string dot_escape(const string &str){
+    string out;
+    for(size_t i = 0; i < str.length(); i++){
+        if(str[i] == '"' || str[i] == '\\')
+            out += '\\';
+        out += str[i];
+    }
+    return out;
+}
+/**
+ *  write_dot()
+ *  - Nodes are named s<section>_b<block>. Loop heads have a double border,
+ *    unresolved blocks are red & returning blocks are rounded.
+ *  - Calls are dashed edges from caller entry to callee entry.
+ *  @param: stream to write graph to
+ *  @return: none
+ */
+void FlowGraph::write_dot(ostream &os) const{
+    os << "digraph flow {\n";
+    os << "    node [shape=box, fontname=\"monospace\"];\n";
+    for(size_t s = 0; s < sections.size(); s++){
+        const SectionFlow &sec = sections[s];
+        string prefix = "s" + to_string(s) + "_b";
+        os << "    subgraph cluster_" << s << " {\n";
+        os << "        label=\"" << dot_escape(sec.name) << "\";\n";
+        for(size_t b = 0; b < sec.blocks.size(); b++){
+            const Block &blk = sec.blocks[b];
+            string label = to_hex(blk.start, 4);
+            if(blk.label != "")
+                label += " " + blk.label;
+            os << "        " << prefix << b << " [label=\"" << dot_escape(label) << "\\n"
+               << blk.count << (blk.count == 1 ? " instruction\"" : " instructions\"");
+            if(blk.loop_head)
+                os << ", peripheries=2";
+            if(blk.unresolved)
+                os << ", color=red";
+            if(blk.returns)
+                os << ", style=rounded";
+            os << "];\n";
+        }
+        os << "    }\n";
+        for(size_t b = 0; b < sec.blocks.size(); b++){
+            for(unsigned int k = sec.succ_offset[b]; k < sec.succ_offset[b+1]; k++){
+                os << "    " << prefix << b << " -> " << prefix << sec.succ[k];
+                if(sec.succ_kind[k] == EDGE_TAKEN)
+                    os << " [label=\"taken\"]";
+                else if(sec.succ_kind[k] == EDGE_JUMP)
+                    os << " [label=\"jump\"]";
+                os << ";\n";
+            }
+        }
+        for(size_t f = 0; f < sec.functions.size(); f++){
+            for(unsigned int k = sec.call_offset[f]; k < sec.call_offset[f+1]; k++){
+                os << "    " << prefix << sec.functions[f].entry << " -> " << prefix
+                   << sec.functions[sec.callee[k]].entry << " [style=dashed, label=\"calls\"];\n";
+            }
+        }
+    }
+    os << "}\n";
+}
+/**
+ *  write_json()
+ *  - Blocks & functions are referred to by their index within the section.
+ *  @param: stream to write document to
+ *  @return: none
+ */
+void FlowGraph::write_json(ostream &os) const{
+    os << "{\"sections\":[";
+    for(size_t s = 0; s < sections.size(); s++){
+        const SectionFlow &sec = sections[s];
+        os << (s ? ",\n" : "\n") << "{\"name\":" << json_string(sec.name) << ",\"blocks\":[";
+        for(size_t b = 0; b < sec.blocks.size(); b++){
+            const Block &blk = sec.blocks[b];
+            os << (b ? ",\n" : "\n");
+            os << "{\"id\":" << b << ",\"start\":" << json_string(to_hex(blk.start, 6))
+               << ",\"end\":" << json_string(to_hex(blk.end, 6))
+               << ",\"instructions\":" << blk.count
+               << ",\"label\":" << json_string(blk.label)
+               << ",\"function\":" << blk.function
+               << ",\"loop_head\":" << (blk.loop_head ? "true" : "false")
+               << ",\"returns\":" << (blk.returns ? "true" : "false")
+               << ",\"unresolved\":" << (blk.unresolved ? "true" : "false")
+               << ",\"succ\":[";
+            for(unsigned int k = sec.succ_offset[b]; k < sec.succ_offset[b+1]; k++){
+                os << (k > sec.succ_offset[b] ? "," : "") << "{\"block\":" << sec.succ[k]
+                   << ",\"kind\":" << json_string(EDGE_NAMES[sec.succ_kind[k]]) << "}";
+            }
+            os << "]}";
+        }
+        os << "],\"functions\":[";
+        for(size_t f = 0; f < sec.functions.size(); f++){
+            os << (f ? ",\n" : "\n");
+            os << "{\"id\":" << f << ",\"name\":" << json_string(sec.functions[f].name)
+               << ",\"entry\":" << sec.functions[f].entry << ",\"calls\":[";
+            for(unsigned int k = sec.call_offset[f]; k < sec.call_offset[f+1]; k++)
+                os << (k > sec.call_offset[f] ? "," : "") << sec.callee[k];
+            os << "]}";
+        }
+        os << "]}";
+    }
+    os << "]}\n";
+}
+/**
+ *  print_stats()
+ *  @param: stream to print stats to
+ *  @return: none
+ */
+void FlowGraph::print_stats(ostream &os) const{
+    size_t num_code = 0, num_blocks = 0, num_edges = 0;
+    size_t num_functions = 0, num_calls = 0, num_loops = 0;
+    for(size_t s = 0; s < sections.size(); s++){
+        const SectionFlow &sec = sections[s];
+        num_code += sec.size();
+        num_blocks += sec.blocks.size();
+        num_edges += sec.succ.size();
+        num_functions += sec.functions.size();
+        num_calls += sec.callee.size();
+        for(size_t b = 0; b < sec.blocks.size(); b++)
+            num_loops += sec.blocks[b].loop_head;
+    }
+    os << "flow graph:       " << num_code << " instructions, " << num_blocks << " blocks, "
+       << num_edges << " edges, " << num_loops << " loop heads\n";
+    os << "call graph:       " << num_functions << " functions, " << num_calls << " call edges\n";
+}
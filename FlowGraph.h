@@ -0,0 +1,147 @@
+/**
+ *  FlowGraph.h
+ *  - Basic blocks & call graph of decoded instructions.
+ *  - SectionFlow collects the instructions of one control section as they
+ *    are decoded, then splits them into basic blocks at J, JEQ, JGT, JLT,
+ *    JSUB & RSUB, their targets and gaps left by data.
+ *  - Block successors & function callees are kept in compressed adjacency
+ *    arrays: edges of block b are succ[succ_offset[b] ... succ_offset[b+1]).
+ *  - FlowGraph holds every section of the deck and exports it as DOT & JSON.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef FLOW_GRAPH_H
+#define FLOW_GRAPH_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include "Statement.h"
+
+using namespace std;
+
+// how an instruction passes on control
+enum Flow : unsigned char {
+    FLOW_NEXT,      // falls through to next instruction
+    FLOW_JUMP,      // J, always taken
+    FLOW_BRANCH,    // JEQ, JGT, JLT, taken or falls through
+    FLOW_CALL,      // JSUB, returns to next instruction
+    FLOW_RETURN     // RSUB
+};
+
+// kind of edge between blocks
+enum EdgeKind : unsigned char {
+    EDGE_FALLTHROUGH,   // next block in address order
+    EDGE_TAKEN,         // conditional branch taken
+    EDGE_JUMP           // unconditional jump
+};
+
+// decoded instruction, only the fields control flow depends on
+struct FlowInstruction
+{
+    unsigned int address;
+    unsigned int target;
+    unsigned char length;
+    Flow flow;
+    // target is known statically, i.e. not indirect or indexed
+    bool direct;
+};
+
+// straight line run of instructions
+struct Block
+{
+    // [start,end) addresses covered by block
+    unsigned int start, end;
+    // index of first instruction & number of instructions
+    unsigned int first, count;
+    // function owning block, -1 if no function reaches it
+    int function;
+    // label at start address, if any
+    string label;
+    // last instruction jumps indirectly or out of section
+    bool unresolved;
+    // last instruction is RSUB
+    bool returns;
+    // target of a backward jump or branch
+    bool loop_head;
+};
+
+// block entered by JSUB, or section entry
+struct Function
+{
+    // entry block
+    unsigned int entry;
+    // label of entry block, or sub_ & entry address
+    string name;
+};
+
+class SectionFlow
+{
+private:
+    // instructions in decode order, sorted by build()
+    vector<FlowInstruction> code;
+    // labels of instructions, in decode order
+    vector<pair<unsigned int, string>> labels;
+    // instruction starting at each address from lo, -1 if none.
+    // Left empty when code is too sparse, instructions are searched instead.
+    vector<int> index;
+    unsigned int lo;
+    // block holding each instruction
+    vector<unsigned int> block_of;
+
+    // index of instruction starting at address, -1 if none
+    int find_instruction(unsigned int addr) const;
+
+    // splits code into blocks & adds their successors
+    void build_blocks();
+
+    // finds functions & which blocks each one owns, then callees
+    void build_calls();
+public:
+    // control section name
+    string name;
+    vector<Block> blocks;
+    // successors of each block: succ[succ_offset[b] ... succ_offset[b+1])
+    vector<unsigned int> succ_offset;
+    vector<unsigned int> succ;
+    vector<EdgeKind> succ_kind;
+    vector<Function> functions;
+    // callees of each function: callee[call_offset[f] ... call_offset[f+1])
+    vector<unsigned int> call_offset;
+    vector<unsigned int> callee;
+
+    SectionFlow() : lo(0){}
+
+    // records statement if it is an instruction
+    void add(const Statement &s);
+
+    // builds blocks & call graph from instructions added so far
+    void build();
+
+    // number of instructions in section
+    size_t size() const { return code.size(); }
+};
+
+class FlowGraph
+{
+private:
+    // control sections in deck order
+    vector<SectionFlow> sections;
+public:
+    // moves built section into graph
+    void add_section(SectionFlow &flow);
+
+    // writes blocks as DOT graph, one cluster per section
+    void write_dot(ostream &os) const;
+
+    // writes blocks & functions as one JSON document
+    void write_json(ostream &os) const;
+
+    // prints number of instructions, blocks, edges & functions
+    void print_stats(ostream &os) const;
+};
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ *  InputFile.cpp
+ *  - Reads first bytes of a file to detect gzip (1F 8B) and zstd
+ *    (28 B5 2F FD) magic numbers.
+ *  - Inflates gzip through InflateBuf one block at a time. The
+ *    Pipeline reads the .obj file on its loader thread so inflating overlaps
+ *    decoding. Concatenated gzip members are inflated one after another.
+ *  - zstd needs libzstd which is not part of this build, such files are
+ *    rejected w/ an error instead of being read as garbage.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include "InputFile.h"
+#include <string>
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+const static size_t BLOCK_SIZE = 1 << 16;   // bytes read or inflated at once
+
+/**
+ *  InflateBuf constructor
+ *  - Window bits 15 + 16 makes zlib expect a gzip header.
+ *  @param: compressed file
+ */
+InflateBuf::InflateBuf(istream &file)
+    : src(file), in_buf(BLOCK_SIZE), out_buf(BLOCK_SIZE),
+      done(false), corrupt(false){
+    memset(&zs, 0, sizeof(zs));
+    if(inflateInit2(&zs, 15 + 16) != Z_OK){
+        done = true;
+        corrupt = true;
+    }
+}
+
+InflateBuf::~InflateBuf(){
+    inflateEnd(&zs);
+}
+/**
+ *  underflow()
+ *  - Called by stream once every inflated byte has been read.
+ *  - Reads compressed blocks until at least one byte is inflated.
+ *  @param: none
+ *  @return: next byte, eof once compressed data ends
+ */
+InflateBuf::int_type InflateBuf::underflow(){
+    if(gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    while(!done){
+        if(zs.avail_in == 0){
+            src.read(&in_buf[0], in_buf.size());
+            zs.next_in = (Bytef *)&in_buf[0];
+            zs.avail_in = src.gcount();
+        }
+        bool no_input = (zs.avail_in == 0);
+        zs.next_out = (Bytef *)&out_buf[0];
+        zs.avail_out = out_buf.size();
+        int ret = inflate(&zs, Z_NO_FLUSH);
+        size_t have = out_buf.size() - zs.avail_out;
+        if(ret == Z_STREAM_END){
+            // another gzip member may follow
+            if(zs.avail_in == 0 && src.peek() == EOF)
+                done = true;
+            else
+                inflateReset(&zs);
+        }
+        else if(ret != Z_OK && !(ret == Z_BUF_ERROR && !no_input)){
+            // bad data, or file ended in the middle of compressed data
+            done = true;
+            corrupt = true;
+        }
+        if(have){
+            setg(&out_buf[0], &out_buf[0], &out_buf[0] + have);
+            return traits_type::to_int_type(*gptr());
+        }
+    }
+    return traits_type::eof();
+}
+/**
+ *  open()
+ *  - Peeks at magic number then rewinds file.
+ *  @param: filename
+ *  @return: true if file can be read, false otherwise.
+ */
+bool InputFile::open(string filename){
+    file.open(filename, ifstream::binary);
+    if(!file.is_open()){
+        error = "***ERROR***\nFile not found. Exitting program.";
+        return false;
+    }
+    unsigned char magic[4] = {0, 0, 0, 0};
+    file.read((char *)magic, 4);
+    file.clear();   // file may be shorter than 4 bytes
+    file.seekg(0);
+    if(magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD){
+        error = "***ERROR***\nzstd compressed files are not supported. Exitting program.";
+        return false;
+    }
+    if(magic[0] == 0x1F && magic[1] == 0x8B){
+        inflater.reset(new InflateBuf(file));
+        inflated.reset(new istream(inflater.get()));
+    }
+    return true;
+}
+
+istream &InputFile::stream(){
+    if(inflated)
+        return *inflated;
+    return file;
+}
+
+bool InputFile::is_compressed() const{
+    return inflater.get() != NULL;
+}
+
+bool InputFile::is_corrupt() const{
+    return inflater && inflater->is_corrupt();
+}
+
+string InputFile::get_error() const{
+    return error;
+}
@@ -0,0 +1,77 @@
+/**
+ *  InputFile.h
+ *  - Opens .obj & .sym files, detecting compression by magic bytes.
+ *  - gzip files are inflated while they are being read, so
+ *    decompressed records go straight to the record parser w/o a temp file.
+ *  - Plain files are read as they are.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef INPUT_FILE_H
+#define INPUT_FILE_H
+
+#include <string>
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <memory>
+#include <vector>
+#include <zlib.h>
+
+using namespace std;
+
+// stream buffer holding bytes inflated from a compressed file
+class InflateBuf : public streambuf
+{
+private:
+    // compressed file being read
+    istream &src;
+    // zlib state
+    z_stream zs;
+    // compressed bytes read from file
+    vector<char> in_buf;
+    // inflated bytes handed to stream
+    vector<char> out_buf;
+    // set once end of compressed data is reached
+    bool done;
+    // set if compressed data could not be inflated
+    bool corrupt;
+protected:
+    // inflates next block of bytes into out_buf
+    int_type underflow();
+public:
+    InflateBuf(istream &file);
+    ~InflateBuf();
+    bool is_corrupt() const { return corrupt; }
+};
+
+class InputFile
+{
+private:
+    // file on disk
+    ifstream file;
+    // inflating buffer & stream reading it, null for plain files
+    unique_ptr<InflateBuf> inflater;
+    unique_ptr<istream> inflated;
+    // message explaining why file could not be opened
+    string error;
+public:
+    // opens file & detects compression. False if file can't be read.
+    bool open(string filename);
+
+    // stream of decompressed bytes
+    istream &stream();
+
+    // true if file is compressed
+    bool is_compressed() const;
+
+    // true if compressed data ended early or could not be inflated
+    bool is_corrupt() const;
+
+    // message explaining why open() failed
+    string get_error() const;
+};
+
+#endif
@@ -0,0 +1,388 @@
+/**
+ *  Pipeline.cpp
+ *  - Loader thread reads .obj records into the records queue.
+ *  - Dispatcher starts a new control section at each header record and
+ *    closes it at its end record.
+ *  - Worker threads pick up sections in deck order. A worker holds one
+ *    record of lookahead since RESB statements need the start address of
+ *    the following record. The last record of a section is its end record.
+ *  - When relocating, sections are loaded one after another starting at the
+ *    load address. Modification records come after text records so a worker
+ *    reads its whole section before decoding it.
+ *  - Writer thread drains each section's chunks in deck order, then writes
+ *    the END statement of the first section.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include "Pipeline.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <iostream>
+
+using namespace std;
+
+const static size_t RECORD_SLOTS = 1024;        // records buffered ahead of dispatcher
+const static size_t SECTION_RECORD_SLOTS = 256; // records buffered ahead of a worker
+const static size_t CHUNK_SLOTS = 64;           // chunks buffered ahead of writer
+
+/**
+ *  Overloaded constructor
+ *  @param: disassembler w/ symbols loaded, object deck stream, listing stream,
+ *          number of worker threads
+ */
+Pipeline::Pipeline(Disassembler &d, istream &input, ostream &output, unsigned int workers)
+    : ds(d), in(input), graph(NULL), records(RECORD_SLOTS),
+      deck_done(false), next_section(0), num_workers(workers ? workers : 1),
+      relocating(false), load_address(0),
+      num_records(0), num_chunks(0), num_bytes(0){
+    renderers.push_back(&listing);
+    sinks.push_back(&output);
+}
+/**
+ *  add_output()
+ *  - Must be called before run().
+ *  @param: renderer of output format, stream to write it to
+ *  @return: none
+ */
+void Pipeline::add_output(const Renderer &renderer, ostream &output){
+    renderers.push_back(&renderer);
+    sinks.push_back(&output);
+}
+/**
+ *  add_analysis()
+ *  - Must be called before run(). Graph is filled in once run() returns.
+ *  @param: graph to add sections to
+ *  @return: none
+ */
+void Pipeline::add_analysis(FlowGraph &g){
+    graph = &g;
+}
+/**
+ *  set_load_address()
+ *  - Enables relocated listing mode.
+ *  @param: address first control section is loaded at
+ *  @return: none
+ */
+void Pipeline::set_load_address(unsigned int addr){
+    relocating = true;
+    load_address = addr;
+}
+/**
+ *  load_stage()
+ *  - Reads object deck line by line and hands each record to the dispatcher.
+ *  @param: none
+ *  @return: none
+ */
+void Pipeline::load_stage(){
+    string line;
+    while(getline(in, line)){
+        records.push(line);
+        num_records++;
+    }
+    records.close();
+}
+/**
+ *  add_section()
+ *  - Appends a section & wakes up idle workers and the writer.
+ *  @param: none
+ *  @return: pointer to new section, owned by sections vector
+ */
+Section *Pipeline::add_section(){
+    lock_guard<mutex> guard(lock);
+    sections.push_back(unique_ptr<Section>(
+        new Section(sections.size(), SECTION_RECORD_SLOTS, CHUNK_SLOTS)));
+    section_added.notify_all();
+    return sections.back().get();
+}
+/**
+ *  wait_section()
+ *  - Blocks until section at index has been added or deck is done.
+ *  @param: index of section in deck
+ *  @return: pointer to section, null if deck has no section at index
+ */
+Section *Pipeline::wait_section(size_t i){
+    unique_lock<mutex> guard(lock);
+    while(i >= sections.size() && !deck_done)
+        section_added.wait(guard);
+    if(i < sections.size())
+        return sections[i].get();
+    return NULL;
+}
+/**
+ *  dispatch_stage()
+ *  - Header record starts a control section, end record closes it.
+ *  - Records found outside of a section start a new one so decks w/o
+ *    header or end records are still decoded. Blank lines are skipped.
+ *  @param: none
+ *  @return: none
+ */
+void Pipeline::dispatch_stage(){
+    string record;
+    Section *cur = NULL;    // section receiving records
+    unsigned int next_load = load_address;  // load address of next section
+    while(records.pop(record)){
+        if(record == "")
+            continue;
+        if(cur == NULL || record[0] == 'H'){
+            if(cur != NULL)
+                cur->records.close();   // previous section had no end record
+            cur = add_section();
+            // set before first push so worker sees it after popping header
+            cur->load_address = next_load;
+            if(relocating && record[0] == 'H'){
+                string name, start, length;
+                Disassembler::split_header(record, name, start, length);
+                next_load += ds.hex_to_int(length);
+            }
+        }
+        cur->records.push(record);
+        if(record[0] == 'E'){
+            cur->records.close();
+            cur = NULL;
+        }
+    }
+    if(cur != NULL)
+        cur->records.close();
+    lock_guard<mutex> guard(lock);
+    deck_done = true;
+    section_added.notify_all();
+}
+/**
+ *  work_stage()
+ *  - Takes the next section waiting for a worker, in deck order.
+ *  @param: none
+ *  @return: none
+ */
+void Pipeline::work_stage(){
+    while(true){
+        Section *sec;
+        {
+            unique_lock<mutex> guard(lock);
+            while(next_section >= sections.size() && !deck_done)
+                section_added.wait(guard);
+            if(next_section >= sections.size())
+                return;     // deck is done & every section was taken
+            sec = sections[next_section++].get();
+        }
+        decode_section(*sec);
+    }
+}
+/**
+ *  next_record()
+ *  @param: section being decoded, string to store record in
+ *  @return: false once section has no more records
+ */
+bool Pipeline::next_record(Section &sec, string &record){
+    if(!relocating)
+        return sec.records.pop(record);
+    if(sec.held_pos >= sec.held.size())
+        return false;
+    record.swap(sec.held[sec.held_pos++]);
+    return true;
+}
+/**
+ *  render()
+ *  - Statements are added to the section's flow graph as well.
+ *  @param: section being decoded, disassembler holding decoded statements
+ *  @return: statements rendered by each renderer, in renderer order
+ */
+vector<string> Pipeline::render(Section &sec, Disassembler &d){
+    vector<Statement> statements;
+    d.take_statements(statements);
+    if(graph)
+        for(size_t i = 0; i < statements.size(); i++)
+            sec.flow.add(statements[i]);
+    vector<string> chunk(renderers.size());
+    for(size_t r = 0; r < renderers.size(); r++)
+        for(size_t i = 0; i < statements.size(); i++)
+            renderers[r]->render(statements[i], chunk[r]);
+    return chunk;
+}
+/**
+ *  decode_section()
+ *  - First section is rendered w/ START, the rest w/ CSECT.
+ *  - When relocating, text & modification records are loaded and the
+ *    section is relocated before any record after the header is decoded.
+ *  - Define & refer records following the header render EXTDEF & EXTREF.
+ *  - Every record in between is decoded once the following record is known.
+ *  - Decode cache of the section is borrowed from ds while decoding, so a
+ *    later run through the same Disassembler reuses it.
+ *  @param: section to decode
+ *  @return: none
+ */
+void Pipeline::decode_section(Section &sec){
+    Disassembler d(ds);     // decode state is private to this section
+    d.use_scope(sec.index);
+    string record;
+    if(!sec.records.pop(record)){
+        sec.chunks.close();
+        return;
+    }
+    // section is moved from the address it was assembled at to its load
+    // address, as the simulator loads it
+    unsigned int start = 0;
+    if(record[0] == 'H'){
+        string name, start_hex, length;
+        Disassembler::split_header(record, name, start_hex, length);
+        start = d.hex_to_int(start_hex);
+    }
+    if(sec.index == 0)
+        d.read_header_row(record);
+    else
+        d.read_csect_row(record);
+    {
+        // decisions made when the deck was decoded before are reused
+        lock_guard<mutex> guard(lock);
+        ds.swap_decode_cache(sec.index, d);
+    }
+    if(relocating){
+        while(sec.records.pop(record)){
+            if(record[0] == 'T')
+                d.load_text_record(record);
+            else if(record[0] == 'M')
+                d.read_modification_record(record);
+            sec.held.push_back(record);
+        }
+        d.relocate(sec.load_address - start);
+    }
+    sec.chunks.push(render(sec, d));
+    bool more = next_record(sec, record);
+    // define & refer records come before the first text record
+    while(more && (record[0] == 'D' || record[0] == 'R')){
+        if(record[0] == 'D')
+            d.read_define_record(record);
+        else
+            d.read_refer_record(record);
+        sec.chunks.push(render(sec, d));
+        more = next_record(sec, record);
+    }
+    // record after the last one decoded is the end record
+    if(more){
+        string following;
+        while(next_record(sec, following)){
+            d.read_text_record(record, following);
+            sec.chunks.push(render(sec, d));
+            record.swap(following);
+        }
+    }
+    // program ends w/ END statement of first section
+    if(sec.index == 0){
+        d.read_end_record();
+        sec.end_statement = render(sec, d);
+    }
+    if(graph)
+        sec.flow.build();
+    sec.cache_hits = d.get_cache_hits();
+    sec.cache_misses = d.get_cache_misses();
+    {
+        lock_guard<mutex> guard(lock);
+        ds.swap_decode_cache(sec.index, d);
+    }
+    sec.chunks.close();
+}
+/**
+ *  write_stage()
+ *  - Writes blocks in deck order, whichever worker finishes first.
+ *  - Each part of a chunk goes to the sink of the renderer that made it.
+ *  @param: none
+ *  @return: none
+ */
+void Pipeline::write_stage(){
+    vector<string> chunk;
+    Section *sec;
+    for(size_t r = 0; r < sinks.size(); r++)
+        *sinks[r] << renderers[r]->header();
+    for(size_t i = 0; (sec = wait_section(i)) != NULL; i++){
+        while(sec->chunks.pop(chunk)){
+            for(size_t r = 0; r < chunk.size(); r++){
+                *sinks[r] << chunk[r];
+                num_bytes += chunk[r].length();
+            }
+            num_chunks++;
+        }
+    }
+    if(sections.size()){
+        chunk = sections[0]->end_statement;
+        for(size_t r = 0; r < chunk.size(); r++){
+            *sinks[r] << chunk[r];
+            num_bytes += chunk[r].length();
+        }
+    }
+    for(size_t r = 0; r < sinks.size(); r++)
+        sinks[r]->flush();
+}
+/**
+ *  run()
+ *  - Starts loader, writer & worker threads, dispatches on calling thread,
+ *    then waits for all threads to finish.
+ *  - Flow graphs built by workers are added to graph in deck order.
+ *  @param: none
+ *  @return: none
+ */
+void Pipeline::run(){
+    thread loader(&Pipeline::load_stage, this);
+    thread writer(&Pipeline::write_stage, this);
+    vector<thread> workers;
+    for(unsigned int i = 0; i < num_workers; i++)
+        workers.push_back(thread(&Pipeline::work_stage, this));
+    dispatch_stage();
+    loader.join();
+    for(unsigned int i = 0; i < workers.size(); i++)
+        workers[i].join();
+    writer.join();
+    if(graph)
+        for(size_t i = 0; i < sections.size(); i++)
+            graph->add_section(sections[i]->flow);
+}
+/**
+ *  print_stats()
+ *  - Stall counts show which stage is the bottleneck: a full records queue
+ *    means decoding is slower than reading, an empty one means I/O bound.
+ *  - Section queue stalls & decode cache use are summed over all sections.
+ *    Hits come from decoding the deck again through the same Disassembler,
+ *    or from records repeating text of earlier ones.
+ *  @param: stream to print stats to
+ *  @return: none
+ */
+void Pipeline::print_stats(ostream &os){
+    size_t dispatch_stalls = 0, worker_in_stalls = 0;
+    size_t worker_out_stalls = 0, writer_stalls = 0;
+    for(size_t i = 0; i < sections.size(); i++){
+        dispatch_stalls += sections[i]->records.producer_stalls();
+        worker_in_stalls += sections[i]->records.consumer_stalls();
+        worker_out_stalls += sections[i]->chunks.producer_stalls();
+        writer_stalls += sections[i]->chunks.consumer_stalls();
+    }
+    os << "records read:     " << num_records << "\n";
+    os << "sections:         " << sections.size() << " (" << num_workers << " workers)\n";
+    os << "chunks written:   " << num_chunks << " (" << num_bytes << " bytes, "
+       << sinks.size() << " outputs)\n";
+    os << "loader stalls:    " << records.producer_stalls() << " (records queue full)\n";
+    os << "dispatch stalls:  " << records.consumer_stalls() << " (records queue empty), "
+       << dispatch_stalls << " (section queue full)\n";
+    os << "worker stalls:    " << worker_in_stalls << " (section queue empty), "
+       << worker_out_stalls << " (chunks queue full)\n";
+    os << "writer stalls:    " << writer_stalls << " (chunks queue empty)\n";
+    os << "decode cache:     " << get_cache_hits() << " hits, " << get_cache_misses()
+       << " misses\n";
+}
+/**
+ *  get_cache_hits() & get_cache_misses()
+ *  @param: none
+ *  @return: decode decisions reused & made, summed over all sections
+ */
+unsigned long long Pipeline::get_cache_hits() const{
+    unsigned long long hits = 0;
+    for(size_t i = 0; i < sections.size(); i++)
+        hits += sections[i]->cache_hits;
+    return hits;
+}
+unsigned long long Pipeline::get_cache_misses() const{
+    unsigned long long misses = 0;
+    for(size_t i = 0; i < sections.size(); i++)
+        misses += sections[i]->cache_misses;
+    return misses;
+}
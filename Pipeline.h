@@ -0,0 +1,148 @@
+/**
+ *  Pipeline.h
+ *  - Instantiates the stages used to disassemble an object deck:
+ *      loader     : reads records from the .obj stream.
+ *      dispatcher : splits records into control sections (H ... E groups).
+ *      workers    : each decodes one control section at a time with its own
+ *                   copy of the Disassembler, so sections run in parallel.
+ *      writer     : flushes rendered chunks to the listing in deck order.
+ *  - Workers pass decoded statements through every enabled Renderer, so one
+ *    decode pass produces all output formats. Each format has its own sink.
+ *  - When analysing, workers also build the flow graph of their section.
+ *  - Stages are connected by bounded RingBuffers so reading the next records
+ *    and flushing previous output overlap decoding.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "Disassembler.h"
+#include "RingBuffer.h"
+#include "Renderer.h"
+#include "FlowGraph.h"
+
+using namespace std;
+
+// records & rendered output of one control section
+struct Section
+{
+    // position of section in deck, selects its symbol scope
+    unsigned int index;
+    // dispatcher -> worker: header, define/refer, text, modification & end records
+    RingBuffer<string> records;
+    // worker -> writer: statements of one record rendered by each renderer
+    RingBuffer<vector<string>> chunks;
+    // END statement, only rendered by first section
+    vector<string> end_statement;
+    // address section is loaded at when relocating
+    unsigned int load_address;
+    // records read ahead of decoding when relocating
+    vector<string> held;
+    size_t held_pos;
+    // instructions & blocks of section, when building flow graph
+    SectionFlow flow;
+    // decode cache hits & misses of worker's Disassembler, for stats
+    unsigned long long cache_hits, cache_misses;
+
+    Section(unsigned int i, size_t record_slots, size_t chunk_slots)
+        : index(i), records(record_slots), chunks(chunk_slots),
+          load_address(0), held_pos(0), cache_hits(0), cache_misses(0){}
+};
+
+class Pipeline
+{
+private:
+    // holds decode tables, symbol scopes & decode cache of each section.
+    // Each worker shares the tables & scopes and borrows the cache of the
+    // section it decodes.
+    Disassembler &ds;
+    // object deck being read
+    istream &in;
+    // renders listing, always the first output
+    ListingRenderer listing;
+    // output formats & the streams they are written to, in matching order
+    vector<const Renderer *> renderers;
+    vector<ostream *> sinks;
+    // collects blocks & calls of every section, null if not analysing
+    FlowGraph *graph;
+    // loader -> dispatcher: one object code record per slot
+    RingBuffer<string> records;
+    // control sections in deck order, guarded by lock
+    vector<unique_ptr<Section>> sections;
+    mutex lock;
+    // signaled when a section is added or the deck has been read
+    condition_variable section_added;
+    // set once dispatcher has seen every record
+    bool deck_done;
+    // index of next section waiting for a worker
+    size_t next_section;
+    // number of worker threads decoding sections
+    unsigned int num_workers;
+    // list object code relocated to load address
+    bool relocating;
+    unsigned int load_address;
+    // number of records read & chunks written, for stats
+    size_t num_records;
+    size_t num_chunks;
+    size_t num_bytes;
+
+    // loader stage, runs on its own thread
+    void load_stage();
+
+    // writer stage, runs on its own thread
+    void write_stage();
+
+    // dispatcher stage, runs on calling thread
+    void dispatch_stage();
+
+    // worker loop, decodes sections until deck is done
+    void work_stage();
+
+    // decodes every record of one control section
+    void decode_section(Section &sec);
+
+    // renders statements decoded so far through every renderer
+    vector<string> render(Section &sec, Disassembler &d);
+
+    // next record of section, from held records when relocating
+    bool next_record(Section &sec, string &record);
+
+    // adds new section to be picked up by a worker & the writer
+    Section *add_section();
+
+    // waits for section at index. Returns null once deck has no such section.
+    Section *wait_section(size_t i);
+public:
+    Pipeline(Disassembler &d, istream &input, ostream &output, unsigned int workers);
+
+    // renders statements through renderer into sink as well as listing
+    void add_output(const Renderer &renderer, ostream &output);
+
+    // builds basic blocks & call graph of every section into graph
+    void add_analysis(FlowGraph &g);
+
+    // relocates listed object code to program loaded at address
+    void set_load_address(unsigned int addr);
+
+    // runs all stages until the end record has been written
+    void run();
+
+    // prints record counts, queue stalls for each stage & decode cache use
+    void print_stats(ostream &os);
+
+    // decode decisions reused from & added to decode caches, after run()
+    unsigned long long get_cache_hits() const;
+    unsigned long long get_cache_misses() const;
+};
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ *  Renderer.cpp
+ *  - ListingRenderer lays out statements in tab separated columns:
+ *    location, label, mnemonic, operand, object code. Operands of format 3
+ *    & 4 instructions are padded to 10 chars so object code lines up.
+ *  - JsonRenderer & CsvRenderer write the same fields for every statement.
+ *    Addresses are 6 hex digits, statements w/o an address leave it empty.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include "Renderer.h"
+#include <string>
+#include <cstdio>
+
+using namespace std;
+
+const static char *KIND_NAMES[] = {
+    "start", "csect", "extdef", "extref", "instruction", "register",
+    "constant", "ltorg", "base", "resb", "end"
+    };
+
+/**
+ *  to_hex()
+ *  @param: value, minimum number of hex digits
+ *  @return: uppercase hex string, padded w/ 0s
+ */
+string to_hex(unsigned int value, int digits){
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%0*X", digits, value);
+    return buf;
+}
+/**
+ *  listing_operand()
+ *  - Names of constants are followed by a tab, then operand is padded w/
+ *    spaces to 10 chars.
+ *  @param: statement
+ *  @return: operand column w/o addressing mode
+ */
+static string listing_operand(const Statement &s){
+    string operand = s.operand;
+    if(s.operand_is_name)
+        operand += '\t';
+    if(s.indexed)
+        operand += ",X";
+    while(operand.length() < 10)
+        operand += ' ';
+    return operand;
+}
+/**
+ *  render()
+ *  - Format 2 statements are listed w/o label.
+ *  - Constants w/ less than 4 nibbles of object code get an extra tab.
+ *  - RESB location is the last 4 digits of the symbol's 6 digit address.
+ *  - Relocated object code is marked w/ R.
+ *  @param: statement, buffer to append line(s) to
+ *  @return: none
+ */
+void ListingRenderer::render(const Statement &s, string &buf) const{
+    string reloc = (s.relocated ? "\tR" : "");
+    switch(s.kind){
+    case Statement::START:
+        buf += "0000\t" + s.label + "\tSTART\t" + s.operand + "\t\n";
+        break;
+    case Statement::CSECT:
+        buf += "0000\t" + s.label + "\tCSECT\t\n";
+        break;
+    case Statement::EXTDEF:
+    case Statement::EXTREF:
+    case Statement::END:
+        buf += "\t\t" + s.mnemonic + "\t" + s.operand + "\n";
+        break;
+    case Statement::REGISTER:
+        buf += to_hex(s.address, 4) + "\t\t" + s.mnemonic + "\t" + s.operand
+             + "\t\t" + s.obj_code + reloc + "\n";
+        break;
+    case Statement::INSTRUCTION:{
+        string label = s.label;
+        buf += to_hex(s.address, 4) + "\t";
+        if(label == "")
+            buf += "\t";
+        if(label.length() > 4)
+            label += '\t';
+        buf += label + s.mnemonic + "\t";
+        if(s.mode)
+            buf += s.mode;
+        buf += listing_operand(s) + "\t" + s.obj_code + reloc + "\n";
+        break;
+    }
+    case Statement::BASE:
+        buf += "\t\tBASE\t" + listing_operand(s) + "\n";
+        break;
+    case Statement::LTORG:
+        buf += "\t\tLTORG\n";
+        break;
+    case Statement::CONSTANT:
+        buf += to_hex(s.address, 4) + "\t" + s.label + "\t" + s.mnemonic + "\t"
+             + s.operand + "\t" + (s.obj_code.length() < 4 ? "\t" : "")
+             + s.obj_code + reloc + "\n";
+        break;
+    case Statement::RESB:
+        buf += to_hex(s.address, 6).substr(2,4) + "\t" + s.label + "\tRESB\t"
+             + s.operand + "\n";
+        break;
+    }
+}
+/**
+ *  json_string()
+ *  @param: string
+ *  @return: string quoted & escaped for JSON
+ */
+string json_string(const string &str){
+    string out = "\"";
+    for(size_t i = 0; i < str.length(); i++){
+        unsigned char c = str[i];
+        if(c == '"' || c == '\\'){
+            out += '\\';
+            out += c;
+        }
+        else if(c < 0x20){
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else
+            out += c;
+    }
+    return out + "\"";
+}
+/**
+ *  render()
+ *  - One JSON object per line. Missing address & target are null.
+ *  @param: statement, buffer to append line to
+ *  @return: none
+ */
+void JsonRenderer::render(const Statement &s, string &buf) const{
+    bool has_target = (s.kind == Statement::INSTRUCTION);
+    buf += "{\"kind\":" + json_string(KIND_NAMES[s.kind]);
+    buf += ",\"section\":" + json_string(s.section);
+    buf += ",\"address\":" + (s.has_address ? json_string(to_hex(s.address, 6)) : "null");
+    buf += ",\"label\":" + json_string(s.label);
+    buf += ",\"mnemonic\":" + json_string(s.mnemonic);
+    buf += ",\"operand\":" + json_string(s.full_operand());
+    buf += ",\"obj_code\":" + json_string(s.obj_code);
+    buf += ",\"format\":" + to_string(s.format);
+    buf += string(",\"relocated\":") + (s.relocated ? "true" : "false");
+    buf += ",\"target\":" + (has_target ? json_string(to_hex(s.target, 6)) : "null");
+    buf += "}\n";
+}
+/**
+ *  csv_field()
+ *  @param: string
+ *  @return: string quoted for CSV, quotes inside doubled
+ */
+static string csv_field(const string &str){
+    string out = "\"";
+    for(size_t i = 0; i < str.length(); i++){
+        if(str[i] == '"')
+            out += '"';
+        out += str[i];
+    }
+    return out + "\"";
+}
+
+string CsvRenderer::header() const{
+    return "kind,section,address,label,mnemonic,operand,obj_code,format,relocated,target\n";
+}
+/**
+ *  render()
+ *  - One row per statement, text fields are always quoted.
+ *  @param: statement, buffer to append row to
+ *  @return: none
+ */
+void CsvRenderer::render(const Statement &s, string &buf) const{
+    bool has_target = (s.kind == Statement::INSTRUCTION);
+    buf += string(KIND_NAMES[s.kind]) + ",";
+    buf += csv_field(s.section) + ",";
+    buf += (s.has_address ? to_hex(s.address, 6) : "") + ",";
+    buf += csv_field(s.label) + ",";
+    buf += csv_field(s.mnemonic) + ",";
+    buf += csv_field(s.full_operand()) + ",";
+    buf += csv_field(s.obj_code) + ",";
+    buf += to_string(s.format) + ",";
+    buf += string(s.relocated ? "1" : "0") + ",";
+    buf += (has_target ? to_hex(s.target, 6) : "") + "\n";
+}
@@ -0,0 +1,58 @@
+/**
+ *  Renderer.h
+ *  - Renderer interface turning decoded Statements into an output format.
+ *  - ListingRenderer: tab separated assembly listing (out.lst).
+ *  - JsonRenderer: one JSON object per statement (JSON Lines).
+ *  - CsvRenderer: one CSV row per statement, w/ a header row.
+ *  - Renderers hold no state so one instance is shared by every worker.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <string>
+#include "Statement.h"
+
+using namespace std;
+
+// uppercase hex string of value, padded w/ 0s to digits
+string to_hex(unsigned int value, int digits);
+
+// string quoted & escaped for JSON
+string json_string(const string &str);
+
+class Renderer
+{
+public:
+    virtual ~Renderer(){}
+
+    // text written once at start of output, e.g. CSV column names
+    virtual string header() const { return ""; }
+
+    // appends rendered statement to buffer
+    virtual void render(const Statement &s, string &buf) const = 0;
+};
+
+class ListingRenderer : public Renderer
+{
+public:
+    void render(const Statement &s, string &buf) const;
+};
+
+class JsonRenderer : public Renderer
+{
+public:
+    void render(const Statement &s, string &buf) const;
+};
+
+class CsvRenderer : public Renderer
+{
+public:
+    string header() const;
+    void render(const Statement &s, string &buf) const;
+};
+
+#endif
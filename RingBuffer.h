@@ -0,0 +1,128 @@
+/**
+ *  RingBuffer.h
+ *  - Bounded single-producer/single-consumer lock-free queue.
+ *  - Connects the loader, decoder and writer stages of the Pipeline so that
+ *    reading records and flushing output overlap decoding.
+ *  - Capacity is rounded up to a power of 2 so slots are found with a mask.
+ *  - Producer & consumer keep their own stall counters for stats reporting.
+ *  - head & tail are kept on separate cache lines by padding rather than
+ *    alignas, since plain new ignores over-aligned types before C++17 and
+ *    queues are members of heap allocated Sections.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+
+using namespace std;
+
+const static size_t CACHE_LINE = 64;    // bytes in a cache line
+
+template <typename T>
+class RingBuffer
+{
+private:
+    // storage for queued items
+    vector<T> slots;
+    // capacity - 1, used to wrap indexes
+    size_t mask;
+    char head_pad[CACHE_LINE];
+    // index of next item to pop. Only written by consumer.
+    atomic<size_t> head;
+    char tail_pad[CACHE_LINE - sizeof(atomic<size_t>)];
+    // index of next free slot. Only written by producer.
+    atomic<size_t> tail;
+    // set by producer once no more items will be pushed
+    atomic<bool> closed;
+    // number of times producer found the queue full
+    size_t full_stalls;
+    // number of times consumer found the queue empty
+    size_t empty_stalls;
+
+    // spin, then yield, then sleep while waiting on the other side.
+    static void backoff(unsigned int &spins){
+        spins++;
+        if(spins < 64)
+            return;
+        if(spins < 1024)
+            this_thread::yield();
+        else
+            this_thread::sleep_for(chrono::microseconds(50));
+    }
+public:
+    // capacity is rounded up to next power of 2
+    RingBuffer(size_t capacity) : head(0), tail(0), closed(false),
+                                  full_stalls(0), empty_stalls(0){
+        size_t n = 2;
+        while(n < capacity)
+            n <<= 1;
+        slots.resize(n);
+        mask = n - 1;
+    }
+
+    // moves item into queue. Returns false if queue is full.
+    bool try_push(T &item){
+        size_t t = tail.load(memory_order_relaxed);
+        if(t - head.load(memory_order_acquire) > mask)
+            return false;
+        slots[t & mask] = std::move(item);
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    // moves item into queue, waiting for a free slot if needed.
+    void push(T item){
+        unsigned int spins = 0;
+        if(try_push(item))
+            return;
+        full_stalls++;
+        while(!try_push(item))
+            backoff(spins);
+    }
+
+    // moves front item out of queue. Returns false if queue is empty.
+    bool try_pop(T &item){
+        size_t h = head.load(memory_order_relaxed);
+        if(h == tail.load(memory_order_acquire))
+            return false;
+        item = std::move(slots[h & mask]);
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // waits for next item. Returns false once queue is closed and drained.
+    bool pop(T &item){
+        unsigned int spins = 0;
+        if(try_pop(item))
+            return true;
+        empty_stalls++;
+        while(true){
+            // read closed flag before retrying so no item pushed before close is lost.
+            bool done = closed.load(memory_order_acquire);
+            if(try_pop(item))
+                return true;
+            if(done)
+                return false;
+            backoff(spins);
+        }
+    }
+
+    // producer signals that no more items will be pushed
+    void close(){
+        closed.store(true, memory_order_release);
+    }
+
+    size_t capacity() const { return mask + 1; }
+    size_t producer_stalls() const { return full_stalls; }
+    size_t consumer_stalls() const { return empty_stalls; }
+};
+
+#endif
@@ -0,0 +1,700 @@
+/**
+ *  Simulator.cpp
+ *  - Sections are loaded like a relocating loader would: the first at the
+ *    load address (or its own start address), each following section right
+ *    after the previous one. Modification records of a section add its load
+ *    address to the fields they name.
+ *  - An address is decoded the first time it is executed. Writes to memory
+ *    drop cached instructions overlapping the written bytes, so code that
+ *    modifies itself is decoded again.
+ *  - L starts out past the end of memory, so RSUB from the main routine
+ *    halts the program. "J *" style loops halt as well.
+ *  - Devices are always ready. RD reads 0, WD bytes are counted per device.
+ *  - Cycles are estimated as 1 per instruction byte, plus memory accesses
+ *    (3 per word, 1 per byte, 6 per float, 3 more if indirect) and extra
+ *    cycles for multiply, divide, float & device instructions.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include "Simulator.h"
+#include "Renderer.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+const static unsigned int MEMORY_SIZE = 1 << 20;    // SIC/XE has 1 MB of memory
+const static unsigned int MEMORY_MASK = MEMORY_SIZE - 1;
+const static unsigned int WORD_MASK = 0xFFFFFF;     // registers hold 24 bits
+
+// register numbers
+const static int REG_A = 0, REG_X = 1, REG_L = 2, REG_B = 3;
+const static int REG_F = 6, REG_PC = 8, REG_SW = 9;
+
+// n i x b p e bits of Decoded::flags
+const static unsigned char F_N = 0x20, F_I = 0x10, F_X = 0x08;
+const static unsigned char F_B = 0x04, F_P = 0x02, F_E = 0x01;
+
+// condition code as stored in SW
+const static unsigned int CC_LESS = 0x40, CC_EQUAL = 0x00, CC_GREATER = 0x80;
+
+// operations, in same order as OP_INFO
+enum Op {
+    OP_UNDECODED, OP_INVALID,
+    OP_ADD, OP_ADDF, OP_ADDR, OP_AND, OP_CLEAR, OP_COMP, OP_COMPF, OP_COMPR,
+    OP_DIV, OP_DIVF, OP_DIVR, OP_FIX, OP_FLOAT, OP_HIO, OP_J, OP_JEQ, OP_JGT,
+    OP_JLT, OP_JSUB, OP_LDA, OP_LDB, OP_LDCH, OP_LDF, OP_LDL, OP_LDS, OP_LDT,
+    OP_LDX, OP_LPS, OP_MUL, OP_MULF, OP_MULR, OP_NORM, OP_OR, OP_RD, OP_RMO,
+    OP_RSUB, OP_SHIFTL, OP_SHIFTR, OP_SIO, OP_SSK, OP_STA, OP_STB, OP_STCH,
+    OP_STF, OP_STI, OP_STL, OP_STS, OP_STSW, OP_STT, OP_STX, OP_SUB, OP_SUBF,
+    OP_SUBR, OP_SVC, OP_TD, OP_TIO, OP_TIX, OP_TIXR, OP_WD,
+    NUM_OPS
+};
+
+// mnemonic, format (3 for 3 & 4), memory access cycles, extra cycles
+struct OpInfo
+{
+    const char *name;
+    unsigned char format;
+    unsigned char memory;
+    unsigned char extra;
+};
+
+const static OpInfo OP_INFO[] = {
+    {"", 0, 0, 0},          {"", 0, 0, 0},
+    {"ADD", 3, 3, 0},       {"ADDF", 3, 6, 4},      {"ADDR", 2, 0, 0},
+    {"AND", 3, 3, 0},       {"CLEAR", 2, 0, 0},     {"COMP", 3, 3, 0},
+    {"COMPF", 3, 6, 4},     {"COMPR", 2, 0, 0},     {"DIV", 3, 3, 16},
+    {"DIVF", 3, 6, 20},     {"DIVR", 2, 0, 16},     {"FIX", 1, 0, 4},
+    {"FLOAT", 1, 0, 4},     {"HIO", 1, 0, 10},      {"J", 3, 0, 0},
+    {"JEQ", 3, 0, 0},       {"JGT", 3, 0, 0},       {"JLT", 3, 0, 0},
+    {"JSUB", 3, 0, 0},      {"LDA", 3, 3, 0},       {"LDB", 3, 3, 0},
+    {"LDCH", 3, 1, 0},      {"LDF", 3, 6, 0},       {"LDL", 3, 3, 0},
+    {"LDS", 3, 3, 0},       {"LDT", 3, 3, 0},       {"LDX", 3, 3, 0},
+    {"LPS", 3, 3, 0},       {"MUL", 3, 3, 8},       {"MULF", 3, 6, 10},
+    {"MULR", 2, 0, 8},      {"NORM", 1, 0, 4},      {"OR", 3, 3, 0},
+    {"RD", 3, 1, 10},       {"RMO", 2, 0, 0},       {"RSUB", 3, 0, 0},
+    {"SHIFTL", 2, 0, 0},    {"SHIFTR", 2, 0, 0},    {"SIO", 1, 0, 10},
+    {"SSK", 3, 3, 0},       {"STA", 3, 3, 0},       {"STB", 3, 3, 0},
+    {"STCH", 3, 1, 0},      {"STF", 3, 6, 0},       {"STI", 3, 3, 0},
+    {"STL", 3, 3, 0},       {"STS", 3, 3, 0},       {"STSW", 3, 3, 0},
+    {"STT", 3, 3, 0},       {"STX", 3, 3, 0},       {"SUB", 3, 3, 0},
+    {"SUBF", 3, 6, 4},      {"SUBR", 2, 0, 0},      {"SVC", 2, 0, 10},
+    {"TD", 3, 1, 10},       {"TIO", 1, 0, 10},      {"TIX", 3, 3, 0},
+    {"TIXR", 2, 0, 0},      {"WD", 3, 1, 10}
+    };
+
+const static char *HALT_NAMES[] = {
+    "running", "step limit reached", "left loaded text", "unknown opcode",
+    "jump to itself", "division by zero"
+    };
+
+// sign extends 24 bit word
+static int word_value(unsigned int w){
+    return (w & 0x800000) ? (int)(w | 0xFF000000) : (int)w;
+}
+// low 24 bits of product of two words, multiplied in 64 bits so large
+// operands don't overflow int
+static unsigned int word_product(unsigned int a, unsigned int b){
+    return (unsigned long long)((long long)word_value(a) * word_value(b)) & WORD_MASK;
+}
+// F truncated to a word, clamped to the 24 bit range since converting NaN or
+// a value out of int range is undefined
+static unsigned int fix_word(double f){
+    if(std::isnan(f))
+        return 0;
+    if(f >= 0x7FFFFF)
+        return 0x7FFFFF;
+    if(f <= -0x800000)
+        return 0x800000;
+    return (int)f & WORD_MASK;
+}
+// condition code of comparing a to b
+static int compare(int a, int b){
+    return (a < b ? -1 : (a > b ? 1 : 0));
+}
+/**
+ *  Overloaded constructor
+ *  - Maps every opcode byte to its operation through the mnemonic table.
+ *    Format 1 & 2 opcodes must match all 8 bits, format 3 & 4 opcodes the
+ *    first 6 since the last 2 are the n & i bits.
+ *  @param: disassembler w/ decode tables & symbols loaded
+ */
+Simulator::Simulator(const Disassembler &d)
+    : ds(d), memory(MEMORY_SIZE, 0), loaded(MEMORY_SIZE, 0), freg(0), cc(0),
+      entry(0), op_counts(NUM_OPS, 0), op_cycles(NUM_OPS, 0), steps(0), cycles(0),
+      decodes(0), halt(HALT_RUNNING), elapsed(0){
+    for(unsigned int b = 0; b < 256; b++){
+        string mnemonic = ds.get_mnemonic_op(to_hex(b & 0xFC, 2), 3);
+        ops[b] = OP_INVALID;
+        for(int op = OP_ADD; op < NUM_OPS; op++){
+            if(mnemonic == OP_INFO[op].name){
+                if(OP_INFO[op].format == 3 || (b & 3) == 0)
+                    ops[b] = op;
+                break;
+            }
+        }
+    }
+    for(int i = 0; i < 10; i++)
+        reg[i] = 0;
+    for(int i = 0; i < 256; i++)
+        device_bytes[i] = 0;
+}
+/**
+ *  load()
+ *  - Records of each section are gathered, then loaded once its end record
+ *    (or next header) is read.
+ *  @param: object deck stream, true to load at load address, load address
+ *  @return: none
+ */
+void Simulator::load(istream &in, bool relocating, unsigned int load_addr){
+    string line;
+    vector<string> records;
+    unsigned int index = 0;
+    unsigned int next_base = load_addr;
+    while(getline(in, line)){
+        if(line.length() && line[line.length()-1] == '\r')
+            line.erase(line.length()-1);
+        if(line == "")
+            continue;
+        if(line[0] == 'H' && records.size()){
+            load_section(records, index++, relocating, next_base);
+            records.clear();
+        }
+        records.push_back(line);
+        if(line[0] == 'E'){
+            load_section(records, index++, relocating, next_base);
+            records.clear();
+        }
+    }
+    if(records.size())
+        load_section(records, index++, relocating, next_base);
+    // only loaded bytes are executed, so tables end after the last one
+    unsigned int end = MEMORY_SIZE;
+    while(end > 0 && !loaded[end-1])
+        end--;
+    cache.assign(end, Decoded());
+    counts.assign(end, 0);
+    cycles_at.assign(end, 0);
+    op_at.assign(end, OP_UNDECODED);
+    sort(symbols.begin(), symbols.end());
+}
+/**
+ *  load_section()
+ *  - Text & modification records are loaded by a Disassembler w/o decode
+ *    tables, which relocates its image before bytes are copied into memory.
+ *  - Entry address comes from the end record of the first section.
+ *  @param: records of section, index of section in deck, true if
+ *          relocating, address next section is loaded at
+ *  @return: none
+ */
+void Simulator::load_section(const vector<string> &records, unsigned int index,
+                             bool relocating, unsigned int &next_base){
+    Disassembler d;     // only holds image & relocation index of section
+    string sec_name, start, length;
+    unsigned int start_addr = 0, sec_length = 0;
+    if(records[0][0] == 'H'){
+        Disassembler::split_header(records[0], sec_name, start, length);
+        start_addr = d.hex_to_int(start);
+        sec_length = d.hex_to_int(length);
+        d.read_csect_row(records[0]);   // modification records name section
+        vector<Statement> unused;
+        d.take_statements(unused);
+    }
+    // section is loaded delta bytes after the address it was assembled at
+    unsigned int delta = 0;
+    if(index > 0 || relocating)
+        delta = next_base - start_addr;
+    vector<pair<unsigned int, unsigned int>> text;  // (address, length)
+    for(size_t i = 0; i < records.size(); i++){
+        const string &r = records[i];
+        if(r[0] == 'T' && r.length() >= 9){
+            d.load_text_record(r);
+            unsigned int addr = d.hex_to_int(r.substr(1,6));
+            unsigned int len = min((size_t)d.hex_to_int(r.substr(7,2)), (r.length() - 9) / 2);
+            text.push_back(make_pair(addr, len));
+        }
+        else if(r[0] == 'M')
+            d.read_modification_record(r);
+        else if(r[0] == 'E' && index == 0){
+            entry = start_addr + delta;
+            if(r.length() >= 7)
+                entry = d.hex_to_int(r.substr(1,6)) + delta;
+        }
+    }
+    if(delta)
+        d.relocate(delta);
+    const vector<unsigned char> &image = d.get_image();
+    for(size_t i = 0; i < text.size(); i++){
+        for(unsigned int a = text[i].first; a < text[i].first + text[i].second; a++){
+            if(a >= image.size())
+                break;
+            memory[(a + delta) & MEMORY_MASK] = image[a];
+            loaded[(a + delta) & MEMORY_MASK] = 1;
+        }
+    }
+    if(index == 0){
+        name = sec_name;
+        if(records.back()[0] != 'E')
+            entry = start_addr + delta;
+    }
+    const SymbolScope *scope = ds.get_scope(index);
+    if(scope){
+        map<string, string>::const_iterator it;
+        for(it = scope->symtab.begin(); it != scope->symtab.end(); it++)
+            symbols.push_back(make_pair((d.hex_to_int(it->first) + delta) & MEMORY_MASK,
+                                        it->second));
+    }
+    next_base = start_addr + delta + sec_length;
+}
+/**
+ *  decode()
+ *  - SIC instructions (n = i = 0) hold a 15 bit address after the x bit.
+ *  - Format 3 displacement is sign extended when pc relative.
+ *  @param: address of instruction
+ *  @return: none
+ */
+void Simulator::decode(unsigned int addr){
+    Decoded d;
+    unsigned char b0 = memory[addr];
+    unsigned char b1 = memory[(addr + 1) & MEMORY_MASK];
+    unsigned char b2 = memory[(addr + 2) & MEMORY_MASK];
+    unsigned char b3 = memory[(addr + 3) & MEMORY_MASK];
+    d.op = ops[b0];
+    d.length = 1;
+    d.flags = 0;
+    d.r1 = b1 >> 4;
+    d.r2 = b1 & 0xF;
+    d.disp = 0;
+    const OpInfo &info = OP_INFO[d.op];
+    if(info.format == 2)
+        d.length = 2;
+    else if(info.format == 3){
+        d.flags = ((b0 & 3) << 4) | (b1 >> 4);
+        d.length = 3;
+        if(!(d.flags & (F_N | F_I))){
+            d.flags &= F_X;
+            d.disp = ((b1 & 0x7F) << 8) | b2;
+        }
+        else if(d.flags & F_E){
+            d.length = 4;
+            d.disp = ((b1 & 0xF) << 16) | (b2 << 8) | b3;
+        }
+        else{
+            d.disp = ((b1 & 0xF) << 8) | b2;
+            if((d.flags & F_P) && (d.disp & 0x800))
+                d.disp -= 0x1000;
+        }
+    }
+    // immediate operands need no memory access, indirect ones need another
+    unsigned char mode = d.flags & (F_N | F_I);
+    d.cycles = d.length + info.extra;
+    if(mode != F_I)
+        d.cycles += info.memory;
+    if(mode == F_N)
+        d.cycles += 3;
+    cache[addr] = d;
+    decodes++;
+}
+/**
+ *  target()
+ *  @param: decoded format 3 or 4 instruction, pc after instruction
+ *  @return: target address
+ */
+unsigned int Simulator::target(const Decoded &d, unsigned int pc) const{
+    unsigned int ta;
+    if(d.flags & F_P)
+        ta = pc + d.disp;
+    else if(d.flags & F_B)
+        ta = reg[REG_B] + d.disp;
+    else
+        ta = d.disp;
+    if(d.flags & F_X)
+        ta += reg[REG_X];
+    return ta & WORD_MASK;
+}
+unsigned int Simulator::read_word(unsigned int addr) const{
+    return (memory[addr & MEMORY_MASK] << 16) | (memory[(addr + 1) & MEMORY_MASK] << 8)
+           | memory[(addr + 2) & MEMORY_MASK];
+}
+void Simulator::write_word(unsigned int addr, unsigned int value){
+    memory[addr & MEMORY_MASK] = (value >> 16) & 0xFF;
+    memory[(addr + 1) & MEMORY_MASK] = (value >> 8) & 0xFF;
+    memory[(addr + 2) & MEMORY_MASK] = value & 0xFF;
+    invalidate(addr, 3);
+}
+/**
+ *  read_float()
+ *  - Floats are 48 bits: sign, 11 bit exponent biased by 1024 and a 36 bit
+ *    fraction f, for a value of 0.f * 2^(exponent - 1024).
+ *  @param: address
+ *  @return: value
+ */
+double Simulator::read_float(unsigned int addr) const{
+    unsigned long long bits = 0;
+    for(int i = 0; i < 6; i++)
+        bits = (bits << 8) | memory[(addr + i) & MEMORY_MASK];
+    int exponent = (bits >> 36) & 0x7FF;
+    double value = ldexp((double)(bits & ((1ULL << 36) - 1)), exponent - 1024 - 36);
+    return (bits >> 47) ? -value : value;
+}
+void Simulator::write_float(unsigned int addr, double value){
+    unsigned long long bits = 0;
+    if(value != 0 && !std::isnan(value)){
+        int exponent;
+        double fraction = frexp(fabs(value), &exponent);
+        exponent += 1024;
+        if(exponent < 0)
+            fraction = exponent = 0;
+        if(exponent > 0x7FF){
+            exponent = 0x7FF;
+            fraction = 1 - ldexp(1.0, -36);
+        }
+        bits = ((unsigned long long)exponent << 36)
+               | (unsigned long long)ldexp(fraction, 36);
+        if(value < 0)
+            bits |= 1ULL << 47;
+    }
+    for(int i = 5; i >= 0; i--){
+        memory[(addr + i) & MEMORY_MASK] = bits & 0xFF;
+        bits >>= 8;
+    }
+    invalidate(addr, 6);
+}
+/**
+ *  word_operand(), byte_operand(), float_operand()
+ *  - Immediate operands are the target address itself, the others are read
+ *    from the effective address, after indirection.
+ *  @param: instruction, target address, effective address
+ *  @return: operand
+ */
+inline unsigned int Simulator::word_operand(const Decoded &d, unsigned int ta,
+                                            unsigned int ea) const{
+    return ((d.flags & (F_N | F_I)) == F_I ? ta : read_word(ea));
+}
+inline unsigned int Simulator::byte_operand(const Decoded &d, unsigned int ta,
+                                            unsigned int ea) const{
+    return ((d.flags & (F_N | F_I)) == F_I ? (ta & 0xFF) : memory[ea & MEMORY_MASK]);
+}
+inline double Simulator::float_operand(const Decoded &d, unsigned int ta,
+                                       unsigned int ea) const{
+    return ((d.flags & (F_N | F_I)) == F_I ? (double)ta : read_float(ea));
+}
+/**
+ *  invalidate()
+ *  - Instructions are at most 4 bytes, so one starting up to 3 bytes before
+ *    the written bytes may overlap them.
+ *  @param: address written, number of bytes
+ *  @return: none
+ */
+void Simulator::invalidate(unsigned int addr, unsigned int length){
+    for(unsigned int a = addr - 3; a != addr + length; a++)
+        if((a & MEMORY_MASK) < cache.size())
+            cache[a & MEMORY_MASK].op = OP_UNDECODED;
+}
+/**
+ *  run()
+ *  - Registers & condition code are reset, memory keeps what earlier runs
+ *    wrote to it.
+ *  @param: maximum number of instructions to execute
+ *  @return: none
+ */
+void Simulator::run(unsigned long long max_steps){
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    for(int i = 0; i < 10; i++)
+        reg[i] = 0;
+    reg[REG_L] = WORD_MASK;     // RSUB from main routine leaves memory
+    freg = 0;
+    cc = 0;
+    unsigned int pc = entry;
+    halt = HALT_RUNNING;
+    while(halt == HALT_RUNNING){
+        if(steps >= max_steps){
+            halt = HALT_STEP_LIMIT;
+            break;
+        }
+        if(pc >= MEMORY_SIZE || !loaded[pc]){
+            halt = HALT_LEFT_TEXT;
+            break;
+        }
+        if(cache[pc].op == OP_UNDECODED)
+            decode(pc);
+        const Decoded d = cache[pc];
+        if(d.op == OP_INVALID){
+            halt = HALT_UNKNOWN_OP;
+            break;
+        }
+        unsigned int addr = pc;
+        pc += d.length;
+        steps++;
+        cycles += d.cycles;
+        counts[addr]++;
+        cycles_at[addr] += d.cycles;
+        op_at[addr] = d.op;
+        op_counts[d.op]++;
+        op_cycles[d.op] += d.cycles;
+
+        // target & effective address of format 3 & 4 instructions
+        unsigned int ta = 0, ea = 0;
+        if(OP_INFO[d.op].format == 3){
+            ta = target(d, pc);
+            ea = ((d.flags & (F_N | F_I)) == F_N ? read_word(ta) : ta);
+        }
+        unsigned int &r1 = reg[d.r1 < 10 ? d.r1 : REG_SW];
+        unsigned int &r2 = reg[d.r2 < 10 ? d.r2 : REG_SW];
+        switch(d.op){
+        case OP_ADD:    reg[REG_A] = (reg[REG_A] + word_operand(d, ta, ea)) & WORD_MASK; break;
+        case OP_SUB:    reg[REG_A] = (reg[REG_A] - word_operand(d, ta, ea)) & WORD_MASK; break;
+        case OP_MUL:    reg[REG_A] = word_product(reg[REG_A], word_operand(d, ta, ea)); break;
+        case OP_DIV:{
+            int m = word_value(word_operand(d, ta, ea));
+            if(m == 0){
+                halt = HALT_DIVIDE_ZERO;
+                break;
+            }
+            reg[REG_A] = (word_value(reg[REG_A]) / m) & WORD_MASK;
+            break;
+        }
+        case OP_AND:    reg[REG_A] &= word_operand(d, ta, ea); break;
+        case OP_OR:     reg[REG_A] = (reg[REG_A] | word_operand(d, ta, ea)) & WORD_MASK; break;
+        case OP_COMP:
+            cc = compare(word_value(reg[REG_A]), word_value(word_operand(d, ta, ea)));
+            break;
+        case OP_TIX:
+            reg[REG_X] = (reg[REG_X] + 1) & WORD_MASK;
+            cc = compare(word_value(reg[REG_X]), word_value(word_operand(d, ta, ea)));
+            break;
+        case OP_ADDF:   freg += float_operand(d, ta, ea); break;
+        case OP_SUBF:   freg -= float_operand(d, ta, ea); break;
+        case OP_MULF:   freg *= float_operand(d, ta, ea); break;
+        case OP_DIVF:{
+            double m = float_operand(d, ta, ea);
+            if(m == 0){
+                halt = HALT_DIVIDE_ZERO;
+                break;
+            }
+            freg /= m;
+            break;
+        }
+        case OP_COMPF:{
+            double m = float_operand(d, ta, ea);
+            cc = (freg < m ? -1 : (freg > m ? 1 : 0));
+            break;
+        }
+        case OP_LDA:    reg[REG_A] = word_operand(d, ta, ea); break;
+        case OP_LDB:    reg[REG_B] = word_operand(d, ta, ea); break;
+        case OP_LDL:    reg[REG_L] = word_operand(d, ta, ea); break;
+        case OP_LDS:    reg[4] = word_operand(d, ta, ea); break;
+        case OP_LDT:    reg[5] = word_operand(d, ta, ea); break;
+        case OP_LDX:    reg[REG_X] = word_operand(d, ta, ea); break;
+        case OP_LDCH:   reg[REG_A] = (reg[REG_A] & 0xFFFF00) | byte_operand(d, ta, ea); break;
+        case OP_LDF:    freg = float_operand(d, ta, ea); break;
+        case OP_STA:    write_word(ea, reg[REG_A]); break;
+        case OP_STB:    write_word(ea, reg[REG_B]); break;
+        case OP_STL:    write_word(ea, reg[REG_L]); break;
+        case OP_STS:    write_word(ea, reg[4]); break;
+        case OP_STT:    write_word(ea, reg[5]); break;
+        case OP_STX:    write_word(ea, reg[REG_X]); break;
+        case OP_STSW:
+            reg[REG_SW] = (cc < 0 ? CC_LESS : (cc > 0 ? CC_GREATER : CC_EQUAL));
+            write_word(ea, reg[REG_SW]);
+            break;
+        case OP_STCH:
+            memory[ea & MEMORY_MASK] = reg[REG_A] & 0xFF;
+            invalidate(ea, 1);
+            break;
+        case OP_STF:    write_float(ea, freg); break;
+        case OP_J:
+            if(ea == addr)
+                halt = HALT_SELF_JUMP;
+            pc = ea;
+            break;
+        case OP_JEQ:    if(cc == 0) pc = ea; break;
+        case OP_JGT:    if(cc > 0) pc = ea; break;
+        case OP_JLT:    if(cc < 0) pc = ea; break;
+        case OP_JSUB:
+            reg[REG_L] = pc;
+            pc = ea;
+            break;
+        case OP_RSUB:   pc = reg[REG_L]; break;
+        case OP_TD:     cc = -1; break;     // device ready
+        case OP_RD:     reg[REG_A] &= 0xFFFF00; break;
+        case OP_WD:     device_bytes[byte_operand(d, ta, ea)]++; break;
+        case OP_ADDR:   r2 = (r2 + r1) & WORD_MASK; break;
+        case OP_SUBR:   r2 = (r2 - r1) & WORD_MASK; break;
+        case OP_MULR:   r2 = word_product(r2, r1); break;
+        case OP_DIVR:
+            if(word_value(r1) == 0){
+                halt = HALT_DIVIDE_ZERO;
+                break;
+            }
+            r2 = (word_value(r2) / word_value(r1)) & WORD_MASK;
+            break;
+        case OP_COMPR:  cc = compare(word_value(r1), word_value(r2)); break;
+        case OP_CLEAR:  r1 = 0; break;
+        case OP_RMO:    r2 = r1; break;
+        case OP_TIXR:
+            reg[REG_X] = (reg[REG_X] + 1) & WORD_MASK;
+            cc = compare(word_value(reg[REG_X]), word_value(r1));
+            break;
+        case OP_SHIFTL:{
+            unsigned int n = (d.r2 + 1) % 24;
+            r1 = ((r1 << n) | (r1 >> (24 - n))) & WORD_MASK;
+            break;
+        }
+        case OP_SHIFTR:
+            r1 = (word_value(r1) >> min(d.r2 + 1, 23)) & WORD_MASK;
+            break;
+        case OP_FIX:    reg[REG_A] = fix_word(freg); break;
+        case OP_FLOAT:  freg = word_value(reg[REG_A]); break;
+        default:        break;  // privileged & I/O channel instructions
+        }
+        if(halt != HALT_RUNNING)
+            pc = addr;
+    }
+    reg[REG_PC] = pc;
+    reg[REG_SW] = (cc < 0 ? CC_LESS : (cc > 0 ? CC_GREATER : CC_EQUAL));
+    elapsed += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+}
+/**
+ *  symbol_at()
+ *  @param: address, offset of address from symbol to fill in
+ *  @return: closest symbol at or before address, empty string if none
+ */
+string Simulator::symbol_at(unsigned int addr, unsigned int &offset) const{
+    vector<pair<unsigned int, string>>::const_iterator it =
+        upper_bound(symbols.begin(), symbols.end(), make_pair(addr, string("\xff")));
+    if(it == symbols.begin()){
+        offset = addr;
+        return "";
+    }
+    --it;
+    offset = addr - it->first;
+    return it->second;
+}
+// one row of a profile table
+struct ProfileRow
+{
+    string name;
+    unsigned int address;
+    unsigned long long count, cycles;
+};
+static bool by_cycles(const ProfileRow &a, const ProfileRow &b){
+    if(a.cycles != b.cycles)
+        return a.cycles > b.cycles;
+    return a.address < b.address;
+}
+/**
+ *  percent()
+ *  @param: part, whole
+ *  @return: part as percentage of whole w/ 2 decimals
+ */
+static string percent(unsigned long long part, unsigned long long whole){
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%6.2f%%", whole ? 100.0 * part / whole : 0.0);
+    return buf;
+}
+/**
+ *  write_profile()
+ *  - Counts per mnemonic are summed by run() as instructions execute, since
+ *    cached instructions may have been dropped by writes since.
+ *  - Executed addresses are walked in order, so cycles of each symbol are
+ *    summed w/ one pass over the symbol table.
+ *  - Tables are sorted by cycles, most expensive first. Every executed
+ *    address is listed unless max_addresses is given.
+ *  @param: stream to write profile to, number of addresses to list, 0 for
+ *          all
+ *  @return: none
+ */
+void Simulator::write_profile(ostream &os, size_t max_addresses) const{
+    const vector<char> &names = ds.get_registers();
+    os << "program\t\t" << name << "\n";
+    os << "entry\t\t" << to_hex(entry, 6) << "\n";
+    os << "halted\t\t" << HALT_NAMES[halt] << " at " << to_hex(reg[REG_PC], 6) << "\n";
+    os << "instructions\t" << steps << "\n";
+    os << "cycles\t\t" << cycles << "\n";
+    os << "registers\t";
+    for(size_t r = 0; r < names.size(); r++){
+        os << names[r] << "=";
+        if((int)r == REG_F)
+            os << freg << " ";
+        else
+            os << to_hex(reg[r], 6) << " ";
+    }
+    os << "SW=" << to_hex(reg[REG_SW], 6) << "\n";
+    for(int dev = 0; dev < 256; dev++)
+        if(device_bytes[dev])
+            os << "device " << to_hex(dev, 2) << "\t" << device_bytes[dev] << " bytes written\n";
+
+    vector<ProfileRow> by_op, by_symbol, hot;
+    for(int op = 0; op < NUM_OPS; op++){
+        ProfileRow row = {OP_INFO[op].name, (unsigned int)op, op_counts[op], op_cycles[op]};
+        by_op.push_back(row);
+    }
+    size_t s = 0;   // next symbol after current address
+    for(unsigned int a = 0; a < counts.size(); a++){
+        if(!counts[a])
+            continue;
+        if(s < symbols.size() && symbols[s].first <= a){
+            while(s < symbols.size() && symbols[s].first <= a)
+                s++;
+            ProfileRow row = {symbols[s-1].second, symbols[s-1].first, 0, 0};
+            by_symbol.push_back(row);
+        }
+        if(by_symbol.empty()){
+            ProfileRow row = {"", 0, 0, 0};
+            by_symbol.push_back(row);
+        }
+        by_symbol.back().count += counts[a];
+        by_symbol.back().cycles += cycles_at[a];
+        unsigned int offset;
+        string symbol = symbol_at(a, offset);
+        if(symbol != "" && offset)
+            symbol += "+" + to_hex(offset, 1);
+        ProfileRow row = {symbol, a, counts[a], cycles_at[a]};
+        hot.push_back(row);
+    }
+    sort(by_op.begin(), by_op.end(), by_cycles);
+    sort(by_symbol.begin(), by_symbol.end(), by_cycles);
+    sort(hot.begin(), hot.end(), by_cycles);
+
+    os << "\nmnemonic\tcount\t\tcycles\t\tcycles %\n";
+    for(size_t i = 0; i < by_op.size() && by_op[i].count; i++){
+        string mnemonic = (by_op[i].name != "" ? by_op[i].name : "?");
+        os << mnemonic << "\t\t" << by_op[i].count << "\t\t" << by_op[i].cycles
+           << "\t\t" << percent(by_op[i].cycles, cycles) << "\n";
+    }
+    os << "\naddress\tsymbol\t\tcount\t\tcycles\t\tcycles %\n";
+    for(size_t i = 0; i < by_symbol.size(); i++){
+        os << to_hex(by_symbol[i].address, 6) << "\t" << by_symbol[i].name << "\t\t"
+           << by_symbol[i].count << "\t\t" << by_symbol[i].cycles
+           << "\t\t" << percent(by_symbol[i].cycles, cycles) << "\n";
+    }
+    os << "\naddress\tlocation\tmnemonic\tcount\t\tcycles\t\tcycles %\n";
+    if(max_addresses && hot.size() > max_addresses)
+        hot.resize(max_addresses);
+    for(size_t i = 0; i < hot.size(); i++){
+        os << to_hex(hot[i].address, 6) << "\t" << hot[i].name << "\t\t"
+           << OP_INFO[op_at[hot[i].address]].name << "\t\t" << hot[i].count << "\t\t"
+           << hot[i].cycles << "\t\t" << percent(hot[i].cycles, cycles) << "\n";
+    }
+}
+/**
+ *  print_stats()
+ *  @param: stream to print stats to
+ *  @return: none
+ */
+void Simulator::print_stats(ostream &os) const{
+    os << "simulated:        " << steps << " instructions, " << cycles << " cycles ("
+       << HALT_NAMES[halt] << ")\n";
+    os << "simulator speed:  " << (elapsed > 0 ? steps / elapsed / 1e6 : 0)
+       << " M instructions/s\n";
+    os << "decoded:          " << decodes << " instructions ("
+       << (steps > decodes ? steps - decodes : 0) << " executed from cache)\n";
+}
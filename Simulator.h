@@ -0,0 +1,145 @@
+/**
+ *  Simulator.h
+ *  - Executes a loaded object deck on a SIC/XE machine: registers A, X, L,
+ *    B, S, T, F, PC & SW and 1 MB of memory filled from text records.
+ *  - Opcodes are looked up in the Disassembler's mnemonic table once per
+ *    address. The decoded instruction is kept in a cache indexed by address
+ *    so executing it again is an array read.
+ *  - Counts executions & estimated cycles of every address, which are
+ *    reported per mnemonic, per symbol and per address.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <istream>
+#include <ostream>
+#include "Disassembler.h"
+
+using namespace std;
+
+// instruction at one address, decoded once & executed from the cache
+struct Decoded
+{
+    // operation, OP_UNDECODED until address is first executed
+    unsigned char op;
+    // instruction length in bytes
+    unsigned char length;
+    // n, i, x, b, p & e bits of format 3 & 4 instructions
+    unsigned char flags;
+    // estimated cycles, see OP_INFO in Simulator.cpp
+    unsigned char cycles;
+    // registers of format 2 instructions
+    unsigned char r1, r2;
+    // displacement or address, sign extended when pc relative
+    int disp;
+};
+
+// reason simulation stopped
+enum Halt {
+    HALT_RUNNING,       // not halted yet
+    HALT_STEP_LIMIT,    // executed maximum number of instructions
+    HALT_LEFT_TEXT,     // PC left bytes loaded from text records
+    HALT_UNKNOWN_OP,    // no opcode at PC
+    HALT_SELF_JUMP,     // unconditional jump to itself
+    HALT_DIVIDE_ZERO    // DIV or DIVR by 0
+};
+
+class Simulator
+{
+private:
+    // decode tables & symbol scopes, read in place, not copied
+    const Disassembler &ds;
+    // operation of each opcode byte, from the mnemonic table
+    unsigned char ops[256];
+    // memory & which bytes were loaded from text records
+    vector<unsigned char> memory;
+    vector<unsigned char> loaded;
+    // decoded instruction at each address up to last loaded byte
+    vector<Decoded> cache;
+    // registers by number: A X L B S T F, PC = 8, SW = 9
+    unsigned int reg[10];
+    double freg;
+    // condition code: -1 less, 0 equal, 1 greater
+    int cc;
+    // address execution starts at
+    unsigned int entry;
+    // program name of first section
+    string name;
+    // symbols of every section at their loaded address, sorted by address
+    vector<pair<unsigned int, string>> symbols;
+    // executions & cycles of each address, same size as cache
+    vector<unsigned long long> counts;
+    vector<unsigned long long> cycles_at;
+    // operation last executed at each address, kept apart from the cache
+    // since writes to code drop cached instructions
+    vector<unsigned char> op_at;
+    // executions & cycles of each operation
+    vector<unsigned long long> op_counts;
+    vector<unsigned long long> op_cycles;
+    // totals
+    unsigned long long steps, cycles;
+    // cache misses, i.e. instructions decoded
+    unsigned long long decodes;
+    // bytes written to each device by WD
+    unsigned long long device_bytes[256];
+    Halt halt;
+    // seconds spent in run()
+    double elapsed;
+
+    // loads text & modification records of one control section
+    void load_section(const vector<string> &records, unsigned int index,
+                      bool relocating, unsigned int &next_base);
+
+    // decodes instruction at address into cache
+    void decode(unsigned int addr);
+
+    // target address of format 3 & 4 instruction, before indirection
+    unsigned int target(const Decoded &d, unsigned int pc) const;
+
+    // reads & writes 3 byte words, wrapping at end of memory
+    unsigned int read_word(unsigned int addr) const;
+    void write_word(unsigned int addr, unsigned int value);
+
+    // reads & writes 6 byte floats
+    double read_float(unsigned int addr) const;
+    void write_float(unsigned int addr, double value);
+
+    // operand of format 3 & 4 instruction: target if immediate, otherwise
+    // the word, byte or float at effective address
+    unsigned int word_operand(const Decoded &d, unsigned int ta, unsigned int ea) const;
+    unsigned int byte_operand(const Decoded &d, unsigned int ta, unsigned int ea) const;
+    double float_operand(const Decoded &d, unsigned int ta, unsigned int ea) const;
+
+    // marks cached instructions overlapping written bytes as undecoded
+    void invalidate(unsigned int addr, unsigned int length);
+
+    // symbol at or before address, empty if none
+    string symbol_at(unsigned int addr, unsigned int &offset) const;
+public:
+    // reads decode tables & symbol scopes of disassembler, which must
+    // outlive the simulator
+    Simulator(const Disassembler &d);
+
+    // loads sections one after another from load address, or from the
+    // start address of the first section if not relocating
+    void load(istream &in, bool relocating, unsigned int load_addr);
+
+    // executes from entry address until halted or max_steps are executed
+    void run(unsigned long long max_steps);
+
+    // writes registers, execution counts & cycles per mnemonic & symbol,
+    // then per address for the max_addresses hottest, or all if 0
+    void write_profile(ostream &os, size_t max_addresses = 0) const;
+
+    // prints instructions executed, speed & cache misses
+    void print_stats(ostream &os) const;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ *  Statement.h
+ *  - One decoded assembly statement, as produced by the Disassembler and
+ *    consumed by Renderers.
+ *  - Fields hold plain values. Column padding & tabs belong to the listing
+ *    layout and are added by ListingRenderer.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <string>
+
+using namespace std;
+
+struct Statement
+{
+    // kind of statement, decides which fields are used
+    enum Kind {
+        START,          // program name & start address
+        CSECT,          // control section name
+        EXTDEF,         // defined names in operand
+        EXTREF,         // referred names in operand
+        INSTRUCTION,    // format 3 or 4 instruction
+        REGISTER,       // format 2 instruction, register in operand
+        CONSTANT,       // BYTE constant or literal (mnemonic '*')
+        LTORG,          // literal pool follows
+        BASE,           // base register set by previous LDB
+        RESB,           // reserved bytes, count in operand
+        END             // program name in operand
+    };
+    Kind kind;
+    // control section statement belongs to
+    string section;
+    // location of statement, has_address is false for directives w/o one.
+    // Load address when the section was relocated.
+    unsigned int address;
+    bool has_address;
+    // label at address
+    string label;
+    // mnemonic op or directive, '+' prefixed for format 4
+    string mnemonic;
+    // operand w/o addressing mode or index register
+    string operand;
+    // '#' immediate, '@' indirect, 0 for simple addressing
+    char mode;
+    // operand is indexed by x register
+    bool indexed;
+    // operand is the name of a constant in littab
+    bool operand_is_name;
+    // object code in hex, after relocation
+    string obj_code;
+    // object code holds a relocated field
+    bool relocated;
+    // instruction format: 2, 3 or 4. 0 for constants & directives
+    int format;
+    // target address of format 3 & 4 instructions. Relocated w/ the
+    // section unless it is an absolute address.
+    unsigned int target;
+
+    Statement(Kind k) : kind(k), address(0), has_address(false), mode(0),
+                        indexed(false), operand_is_name(false),
+                        relocated(false), format(0), target(0){}
+
+    // operand as written in source, w/ addressing mode & index register
+    string full_operand() const{
+        string s = operand;
+        if(mode)
+            s = mode + s;
+        if(indexed)
+            s += ",X";
+        return s;
+    }
+};
+
+#endif
@@ -0,0 +1,617 @@
+/**
+ *  fuzz_dissem.cpp
+ *  - Fuzzing harness for reading object decks & symbol files and decoding.
+ *  - An input is an object deck, a NUL byte, then a symbol file.
+ *  - Every input is decoded by the sequential path (object_code vector read
+ *    one record after another) and by the Pipeline, plainly and in
+ *    relocated mode.
+ *  - Sequential path & the Pipeline each decode the deck a second time
+ *    through the same Disassembler. The second pass must give the same
+ *    listing and read its decisions from the decode cache. An address range
+ *    is queried twice as well, the second query must hand over the same
+ *    statements w/o resolving any.
+ *  - The Simulator loads every input and executes a few instructions of it.
+ *  - Differential mode checks Pipeline listing against the sequential path
+ *    and against the original disassembler (dissem_ref, built from ref/),
+ *    which shares no code w/ the decoder under test, for decks holding a
+ *    single control section. dissem_ref runs in a child process since it
+ *    crashes or loops on many malformed decks; such inputs are only counted
+ *    as not compared.
+ *  - Built w/ -DLIBFUZZER it defines LLVMFuzzerTestOneInput for libFuzzer,
+ *    which checks against the sequential path only. Otherwise it is a
+ *    standalone/AFL driver:
+ *      fuzz_dissem [-d] [-r dissem_ref] [-n N] [-t secs] [-p file.obj file.sym] [files...]
+ *          files   inputs to run once each, stdin if none are given (AFL)
+ *          -p      adds an .obj/.sym pair as input
+ *          -n N    runs N mutations of the inputs and reports execs/sec
+ *          -d      differential mode
+ *          -r      original disassembler to compare against, ./dissem_ref
+ *          -t secs input running longer than secs is reported as a hang
+ *  - Crashing, hanging & mismatching inputs are saved to crash-input,
+ *    hang-input & diff-input.
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <csignal>
+#include <climits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "Disassembler.h"
+#include "Pipeline.h"
+#include "Opcodes.h"
+#include "Renderer.h"
+#include "FlowGraph.h"
+#include "Simulator.h"
+
+using namespace std;
+
+const static unsigned long long SIM_STEPS = 10000;  // instructions simulated per input
+
+/**
+ *  comparable()
+ *  - Pipeline splits decks into control sections, skips blank lines and
+ *    lists define/refer records. Reference path treats every record after
+ *    the header as a text record, so listings only match for decks w/o any.
+ *  @param: records of object deck
+ *  @return: true if both paths must produce the same listing
+ */
+static bool comparable(const string &obj){
+    istringstream in(obj);
+    vector<string> records;
+    string line;
+    while(getline(in, line)){
+        if(line == "")
+            return false;
+        records.push_back(line);
+    }
+    if(records.empty())
+        return false;
+    for(size_t i = 0; i < records.size(); i++){
+        char type = records[i][0];
+        if(type == 'H' && i > 0)
+            return false;
+        if(type == 'E' && i+1 < records.size())
+            return false;
+        if(i == 1 && (type == 'D' || type == 'R'))
+            return false;
+    }
+    return true;
+}
+// listings of decoding a deck twice through one Disassembler, and decode
+// decisions reused & made by each pass
+struct Passes
+{
+    string listing[2];
+    unsigned long long hits[2], misses[2];
+};
+
+// decode decisions of second passes & how many were read from the cache
+static unsigned long long repeat_decisions = 0, repeat_hits = 0;
+// statements handed over by second range queries
+static unsigned long long repeat_statements = 0;
+
+/**
+ *  same_listing()
+ *  @param: both passes, name of path decoding them
+ *  @return: false if second pass listed something else than the first
+ */
+static bool same_listing(const Passes &p, const char *path){
+    if(p.listing[1] == p.listing[0])
+        return true;
+    cerr << "***CACHE MISMATCH*** (" << path << ")\n--- first decode\n"
+         << p.listing[0] << "--- decoded again\n" << p.listing[1];
+    return false;
+}
+
+/**
+ *  check_passes()
+ *  - Second pass makes as many decisions as the first. Every one the first
+ *    pass reused is cached for the second as well, so it can't miss more.
+ *  @param: both passes, name of path decoding them
+ *  @return: false if listings differ or the cache was not reused
+ */
+static bool check_passes(const Passes &p, const char *path){
+    if(!same_listing(p, path))
+        return false;
+    if(p.hits[1] + p.misses[1] != p.hits[0] + p.misses[0] || p.misses[1] > p.misses[0]){
+        cerr << "***CACHE NOT REUSED*** (" << path << ")\nfirst decode: " << p.hits[0]
+             << " hits, " << p.misses[0] << " misses, decoded again: " << p.hits[1]
+             << " hits, " << p.misses[1] << " misses\n";
+        return false;
+    }
+    repeat_decisions += p.hits[1] + p.misses[1];
+    repeat_hits += p.hits[1];
+    return true;
+}
+/**
+ *  check_range_passes()
+ *  - Hits & misses are statements handed over from the cache & resolved.
+ *    Statements are resolved by the first query only.
+ *  @param: both queries
+ *  @return: false if listings differ or the second query resolved any
+ */
+static bool check_range_passes(const Passes &p){
+    if(!same_listing(p, "range query"))
+        return false;
+    if(p.misses[1] || p.hits[0]){
+        cerr << "***CACHE NOT REUSED*** (range query)\nfirst query: " << p.hits[0]
+             << " statements, " << p.misses[0] << " resolved, queried again: " << p.hits[1]
+             << " statements, " << p.misses[1] << " resolved\n";
+        return false;
+    }
+    repeat_statements += p.hits[1];
+    return true;
+}
+/**
+ *  sequential_listing()
+ *  - Decodes deck through object_code vector, one record after another,
+ *    twice.
+ *  @param: object deck, symbol file, passes to fill in
+ *  @return: none
+ */
+static void sequential_listing(const string &obj, const string &sym, Passes &p){
+    Disassembler ds(mnemonics, ops);
+    istringstream obj_in(obj), sym_in(sym);
+    ds.read_obj_stream(obj_in);
+    ds.read_sym_stream(sym_in);
+    for(int pass = 0; pass < 2; pass++){
+        unsigned long long hits = ds.get_cache_hits(), misses = ds.get_cache_misses();
+        ds.read_header_row();
+        ds.read_text_record();
+        ds.read_end_record();
+        p.listing[pass] = ds.take_output();
+        p.hits[pass] = ds.get_cache_hits() - hits;
+        p.misses[pass] = ds.get_cache_misses() - misses;
+    }
+}
+/**
+ *  range_listing()
+ *  - Queries the same address range twice, as a library caller would.
+ *  @param: object deck, symbol file, passes to fill in w/ statements handed
+ *          over & resolved
+ *  @return: none
+ */
+static void range_listing(const string &obj, const string &sym, Passes &p){
+    const static unsigned int RANGE_FROM = 0x10, RANGE_TO = 0x400;
+    Disassembler ds(mnemonics, ops);
+    ListingRenderer listing;
+    istringstream obj_in(obj), sym_in(sym);
+    ds.read_obj_stream(obj_in);
+    ds.read_sym_stream(sym_in);
+    for(int pass = 0; pass < 2; pass++){
+        unsigned long long hits = ds.get_range_hits(), misses = ds.get_range_misses();
+        vector<Statement> statements;
+        ds.read_range(RANGE_FROM, RANGE_TO, statements);
+        p.listing[pass] = "";
+        for(size_t i = 0; i < statements.size(); i++)
+            listing.render(statements[i], p.listing[pass]);
+        p.hits[pass] = ds.get_range_hits() - hits;
+        p.misses[pass] = ds.get_range_misses() - misses;
+    }
+}
+/**
+ *  pipeline_listing()
+ *  - Decodes deck through the Pipeline, rendering JSON & CSV and building
+ *    the flow graph as well, then runs a second Pipeline over the same
+ *    Disassembler, which reuses the decode cache of every section.
+ *  @param: object deck, symbol file, number of workers, hex load address or
+ *          empty string to list w/o relocating, passes to fill in
+ *  @return: none
+ */
+static void pipeline_listing(const string &obj, const string &sym,
+                             unsigned int workers, string load_address, Passes &p){
+    Disassembler ds(mnemonics, ops);
+    istringstream sym_in(sym);
+    ds.read_sym_stream(sym_in, workers);
+    for(int pass = 0; pass < 2; pass++){
+        istringstream obj_in(obj);
+        ostringstream listing, json_out, csv_out;
+        JsonRenderer json;
+        CsvRenderer csv;
+        FlowGraph graph;
+        Pipeline pipeline(ds, obj_in, listing, workers);
+        pipeline.add_output(json, json_out);
+        pipeline.add_output(csv, csv_out);
+        pipeline.add_analysis(graph);
+        if(load_address != "")
+            pipeline.set_load_address(ds.hex_to_int(load_address));
+        pipeline.run();
+        ostringstream dot_out, flow_out;
+        graph.write_dot(dot_out);
+        graph.write_json(flow_out);
+        p.listing[pass] = listing.str();
+        p.hits[pass] = pipeline.get_cache_hits();
+        p.misses[pass] = pipeline.get_cache_misses();
+    }
+}
+/**
+ *  simulate()
+ *  @param: object deck, symbol file
+ *  @return: none
+ */
+static void simulate(const string &obj, const string &sym){
+    Disassembler ds(mnemonics, ops);
+    istringstream obj_in(obj), sym_in(sym);
+    ds.read_sym_stream(sym_in);
+    Simulator sim(ds);
+    sim.load(obj_in, true, 0x1000);
+    sim.run(SIM_STEPS);
+    ostringstream prof_out;
+    sim.write_profile(prof_out);
+}
+/**
+ *  run_input()
+ *  @param: object deck & symbol file separated by NUL, differential flag,
+ *          string to store pipeline listing in
+ *  @return: false if pipeline listing does not match sequential listing, or
+ *          decoding again does not match first decode or misses the cache
+ */
+static bool run_input(const string &data, bool differential, string &listing){
+    size_t split = data.find('\0');
+    string obj = data.substr(0, split);
+    string sym = (split == string::npos ? "" : data.substr(split + 1));
+    Passes sequential, range, pipeline, relocated;
+    sequential_listing(obj, sym, sequential);
+    range_listing(obj, sym, range);
+    pipeline_listing(obj, sym, 2, "", pipeline);
+    pipeline_listing(obj, sym, 1, "1000", relocated);
+    if(!check_passes(sequential, "sequential") || !check_range_passes(range)
+       || !check_passes(pipeline, "pipeline") || !check_passes(relocated, "relocated"))
+        return false;
+    const string &expected = sequential.listing[0];
+    listing = pipeline.listing[0];
+    simulate(obj, sym);
+    if(differential && comparable(obj) && listing != expected){
+        cerr << "***MISMATCH***\n--- sequential\n" << expected
+             << "--- pipeline\n" << listing;
+        return false;
+    }
+    return true;
+}
+
+#ifdef LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size){
+    string listing;
+    if(!run_input(string((const char *)data, size), true, listing))
+        abort();
+    return 0;
+}
+
+#else
+
+// input being run, saved by signal handlers
+static const char *cur_data = NULL;
+static size_t cur_size = 0;
+
+/**
+ *  save_input()
+ *  - Only uses async-signal-safe calls so it can run in a signal handler.
+ *  @param: filename
+ *  @return: none
+ */
+static void save_input(const char *filename){
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return;
+    size_t done = 0;
+    while(done < cur_size){
+        ssize_t n = write(fd, cur_data + done, cur_size - done);
+        if(n <= 0)
+            break;
+        done += n;
+    }
+    close(fd);
+}
+
+static void on_crash(int sig){
+    save_input("crash-input");
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void on_hang(int){
+    save_input("hang-input");
+    const char msg[] = "***HANG*** input saved to hang-input\n";
+    write(2, msg, sizeof(msg) - 1);
+    _exit(2);
+}
+
+// xorshift, deterministic so runs can be repeated
+static uint32_t rng_state = 2463534242u;
+static uint32_t rng(){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/**
+ *  mutate()
+ *  - Replaces, inserts or deletes bytes biased towards hex digits, record
+ *    types & line breaks, or duplicates a line.
+ *  @param: input to mutate
+ *  @return: mutated input
+ */
+static string mutate(string s){
+    const static string alphabet = "0123456789ABCDEFHTMEDR \n=X'-+";
+    int num_edits = 1 + rng() % 4;
+    for(int i = 0; i < num_edits; i++){
+        size_t pos = (s.empty() ? 0 : rng() % s.size());
+        char c = alphabet[rng() % alphabet.size()];
+        if(rng() % 16 == 0)
+            c = (char)rng();    // any byte
+        switch(rng() % 5){
+        case 0:
+            if(!s.empty())
+                s[pos] = c;
+            break;
+        case 1:
+            s.insert(s.begin() + pos, c);
+            break;
+        case 2:
+            if(!s.empty())
+                s.erase(pos, 1 + rng() % 4);
+            break;
+        case 3:{
+            // duplicate line containing pos
+            size_t start = s.rfind('\n', pos);
+            start = (start == string::npos ? 0 : start + 1);
+            size_t end = s.find('\n', pos);
+            end = (end == string::npos ? s.size() : end + 1);
+            s.insert(start, s.substr(start, end - start));
+            break;
+        }
+        default:
+            if(!s.empty())
+                s[pos] = alphabet[rng() % 16];  // hex digit
+        }
+    }
+    return s;
+}
+
+static string read_file(const char *filename, bool &ok){
+    ifstream file(filename, ifstream::binary);
+    ok = file.is_open();
+    ostringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+/**
+ *  original_comparable()
+ *  - dissem_ref keeps every row in one symtab & littab and lists RESB
+ *    addresses straight from the symbol table text, so its listing only
+ *    has to match for one Symbol table followed by at most one Name table
+ *    whose symbol addresses are 6 uppercase hex digits.
+ *  - Both read past the end of a text record whose object code is
+ *    shorter than its length field, each in its own way, so every text
+ *    record has to hold exactly as many bytes as it claims.
+ *  - dissem_ref reads past its register table for a register nibble
+ *    above 6, which the pipeline lists as '?', so listings naming a '?'
+ *    register are not compared either.
+ *  @param: records of object deck, symbol file, listing of pipeline
+ *  @return: true if pipeline must list deck the same as dissem_ref
+ */
+static bool original_comparable(const string &obj, const string &sym,
+                                const string &listing){
+    if(!comparable(obj))
+        return false;
+    istringstream records(obj);
+    string record;
+    while(getline(records, record)){
+        if(record[0] != 'T')
+            continue;
+        if(record[record.size()-1] == '\r')
+            record.erase(record.size()-1);
+        if(record.size() < 9 || !isxdigit(record[7]) || !isxdigit(record[8]))
+            return false;
+        if(record.size() != 9 + 2*stoul(record.substr(7, 2), nullptr, 16))
+            return false;
+    }
+    istringstream rows(listing);
+    string row;
+    while(getline(rows, row)){
+        istringstream fields(row);
+        string field;
+        for(int i = 0; i < 4 && getline(fields, field, '\t'); i++){
+            if(i == 3 && field.find('?') != string::npos)
+                return false;
+        }
+    }
+    istringstream in(sym);
+    string line;
+    int sym_tables = 0, lit_tables = 0;
+    while(getline(in, line)){
+        if(line.size() <= 1)
+            continue;
+        if(line.compare(0, 6, "Symbol") == 0){
+            if(sym_tables++ || lit_tables)
+                return false;
+        }
+        else if(line.compare(0, 4, "Name") == 0){
+            if(lit_tables++)
+                return false;
+        }
+        else if(sym_tables && !lit_tables && line[0] != '-'){
+            istringstream row(line);
+            string name, addr;
+            row >> name >> addr;
+            if(addr.size() != 6 || addr.find_first_not_of("0123456789ABCDEF") != string::npos)
+                return false;
+        }
+    }
+    return true;
+}
+/**
+ *  original_listing()
+ *  - Runs dissem_ref on input in its own directory, killed by SIGALRM if it
+ *    runs longer than timeout. Its output is discarded.
+ *  @param: absolute path of dissem_ref, directory to run it in, object deck,
+ *          symbol file, timeout in seconds, string to store listing in
+ *  @return: false if it could not be run, crashed, hung or exited w/ error
+ */
+static bool original_listing(const string &ref, const string &dir, const string &obj,
+                             const string &sym, unsigned int timeout, string &listing){
+    string obj_file = dir + "/in.obj", sym_file = dir + "/in.sym";
+    string lst_file = dir + "/out.lst";
+    ofstream(obj_file.c_str(), ofstream::binary) << obj;
+    ofstream(sym_file.c_str(), ofstream::binary) << sym;
+    unlink(lst_file.c_str());
+    pid_t pid = fork();
+    if(pid == 0){
+        int null = open("/dev/null", O_WRONLY);
+        if(chdir(dir.c_str()) != 0 || null < 0)
+            _exit(126);
+        dup2(null, 1);
+        dup2(null, 2);
+        signal(SIGALRM, SIG_DFL);
+        alarm(timeout);     // pending alarm is kept across exec
+        execl(ref.c_str(), ref.c_str(), "in.obj", "in.sym", (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    if(pid < 0 || waitpid(pid, &status, 0) != pid)
+        return false;
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return false;
+    bool ok;
+    listing = read_file(lst_file.c_str(), ok);
+    return ok;
+}
+
+int main(int argc, char *argv[]){
+    bool differential = false;
+    long iterations = 0;
+    unsigned int timeout = 1;
+    string ref = "dissem_ref";
+    vector<string> inputs;
+    for(int i = 1; i < argc; i++){
+        string flag = argv[i];
+        bool ok = true;
+        if(flag == "-d")
+            differential = true;
+        else if(flag == "-n" && i+1 < argc)
+            iterations = atol(argv[++i]);
+        else if(flag == "-t" && i+1 < argc)
+            timeout = atoi(argv[++i]);
+        else if(flag == "-r" && i+1 < argc)
+            ref = argv[++i];
+        else if(flag == "-p" && i+2 < argc){
+            bool ok2;
+            string obj = read_file(argv[i+1], ok);
+            string sym = read_file(argv[i+2], ok2);
+            ok = ok && ok2;
+            inputs.push_back(obj + '\0' + sym);
+            i += 2;
+        }
+        else
+            inputs.push_back(read_file(argv[i], ok));
+        if(!ok){
+            cout<<"***ERROR***\nFile not found. Exitting program."<<endl;
+            return 1;
+        }
+    }
+    // AFL feeds input through stdin when no file is given
+    if(inputs.empty()){
+        ostringstream ss;
+        ss << cin.rdbuf();
+        inputs.push_back(ss.str());
+    }
+    signal(SIGSEGV, on_crash);
+    signal(SIGABRT, on_crash);
+    signal(SIGBUS, on_crash);
+    signal(SIGFPE, on_crash);
+    signal(SIGALRM, on_hang);
+    // dissem_ref is run from its own directory, so its path must be absolute
+    char path[PATH_MAX], dir[] = "/tmp/fuzz_dissem.XXXXXX";
+    if(differential){
+        if(access(ref.c_str(), X_OK) != 0 || !realpath(ref.c_str(), path)){
+            cout<<"***ERROR***\nBuild "<<ref<<" first (make dissem_ref)."<<endl;
+            return 1;
+        }
+        ref = path;
+        if(!mkdtemp(dir)){
+            perror("mkdtemp");
+            return 1;
+        }
+    }
+
+    long execs = 0, compared = 0, not_compared = 0;
+    double slowest = 0, ref_elapsed = 0;
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    long total = (iterations > 0 ? iterations : (long)inputs.size());
+    for(long n = 0; n < total; n++){
+        string data = inputs[n % inputs.size()];
+        if(iterations > 0)
+            data = mutate(data);
+        cur_data = data.data();
+        cur_size = data.size();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        string listing;
+        alarm(timeout);
+        bool ok = run_input(data, differential, listing);
+        alarm(0);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if(secs > slowest)
+            slowest = secs;
+        execs++;
+        size_t split = data.find('\0');
+        string obj = data.substr(0, split);
+        string sym = (split == string::npos ? "" : data.substr(split + 1));
+        if(ok && differential && original_comparable(obj, sym, listing)){
+            string original;
+            start = chrono::steady_clock::now();
+            bool ran = original_listing(ref, dir, obj, sym, timeout, original);
+            ref_elapsed += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if(!ran)
+                not_compared++;
+            else if(listing != original){
+                cerr << "***MISMATCH***\n--- dissem_ref\n" << original
+                     << "--- pipeline\n" << listing;
+                ok = false;
+            }
+            else
+                compared++;
+        }
+        if(!ok){
+            save_input("diff-input");
+            cerr << "input saved to diff-input" << endl;
+            return 1;
+        }
+    }
+    if(differential){
+        unlink((string(dir) + "/in.obj").c_str());
+        unlink((string(dir) + "/in.sym").c_str());
+        unlink((string(dir) + "/out.lst").c_str());
+        rmdir(dir);
+    }
+    // time spent in dissem_ref is not part of execs/sec
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    elapsed -= ref_elapsed;
+    cerr << "execs:            " << execs << "\n";
+    cerr << "elapsed:          " << elapsed << " s\n";
+    cerr << "execs/sec:        " << (elapsed > 0 ? execs / elapsed : 0) << "\n";
+    cerr << "slowest exec:     " << slowest * 1000 << " ms\n";
+    if(differential){
+        cerr << "compared:         " << compared << " (single section decks, same as dissem_ref)\n";
+        cerr << "not compared:     " << not_compared << " (dissem_ref crashed, hung or failed)\n";
+    }
+    cerr << "decoded again:    " << repeat_hits << " of " << repeat_decisions
+         << " decisions from decode cache\n";
+    cerr << "queried again:    " << repeat_statements << " statements from decode cache\n";
+    return 0;
+}
+
+#endif
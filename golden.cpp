@@ -0,0 +1,230 @@
+/**
+ *  golden.cpp
+ *  - Golden output tests: runs dissem on small fixture decks and compares
+ *    every output file against the one kept w/ the fixture.
+ *  - Each directory under tests/ is one case holding deck.obj, deck.sym, a
+ *    one line args file w/ the flags to run dissem with, and the expected
+ *    outputs: out.lst, out.jsonl, out.csv, out.dot, out.flow.json,
+ *    out.prof and stdout, whichever the flags produce.
+ *  - dissem runs in a fresh temp directory per case, so out.lst starts
+ *    empty. Its stderr is discarded since stats hold timings.
+ *  - Outputs must match byte for byte. An output the case expects but the
+ *    run did not write fails as well.
+ *      golden [-u] [-d dir] [dissem]
+ *          -u      rewrites expected outputs of every case from this run,
+ *                  after a change to the output was checked by hand
+ *          -d dir  directory holding the cases, tests by default
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+// fixture files, the rest of a case directory are expected outputs
+const static string DECK_OBJ = "deck.obj", DECK_SYM = "deck.sym", ARGS = "args";
+
+static bool read_file(const string &filename, string &data){
+    ifstream file(filename.c_str(), ifstream::binary);
+    if(!file.is_open())
+        return false;
+    ostringstream ss;
+    ss << file.rdbuf();
+    data = ss.str();
+    return true;
+}
+
+static bool write_file(const string &filename, const string &data){
+    ofstream file(filename.c_str(), ofstream::binary);
+    file << data;
+    return file.good();
+}
+/**
+ *  list_dir()
+ *  @param: directory, true to list subdirectories, false to list files
+ *  @return: names of entries, sorted
+ */
+static vector<string> list_dir(const string &dir, bool dirs){
+    vector<string> names;
+    DIR *d = opendir(dir.c_str());
+    if(!d)
+        return names;
+    struct dirent *e;
+    while((e = readdir(d)) != NULL){
+        string name = e->d_name;
+        struct stat st;
+        if(name == "." || name == ".." || stat((dir + "/" + name).c_str(), &st) != 0)
+            continue;
+        if(S_ISDIR(st.st_mode) == dirs)
+            names.push_back(name);
+    }
+    closedir(d);
+    sort(names.begin(), names.end());
+    return names;
+}
+/**
+ *  remove_dir()
+ *  - Directories made by the test only hold files.
+ *  @param: directory
+ *  @return: none
+ */
+static void remove_dir(const string &dir){
+    vector<string> files = list_dir(dir, false);
+    for(size_t i = 0; i < files.size(); i++)
+        unlink((dir + "/" + files[i]).c_str());
+    rmdir(dir.c_str());
+}
+/**
+ *  run_case()
+ *  - Child changes into a fresh temp directory & writes its stdout to a
+ *    file named stdout there.
+ *  @param: absolute paths of binary & case directory, temp directory to
+ *          fill in
+ *  @return: true if dissem exited w/ status 0
+ */
+static bool run_case(const string &binary, const string &dir, string &out_dir){
+    char tmp[] = "/tmp/golden.XXXXXX";
+    if(!mkdtemp(tmp)){
+        perror("mkdtemp");
+        return false;
+    }
+    out_dir = tmp;
+    string args_line;
+    read_file(dir + "/" + ARGS, args_line);
+    vector<string> args;
+    args.push_back(binary);
+    args.push_back(dir + "/" + DECK_OBJ);
+    args.push_back(dir + "/" + DECK_SYM);
+    istringstream in(args_line);
+    string arg;
+    while(in >> arg)
+        args.push_back(arg);
+    vector<char *> argv;
+    for(size_t i = 0; i < args.size(); i++)
+        argv.push_back(&args[i][0]);
+    argv.push_back(NULL);
+    pid_t pid = fork();
+    if(pid == 0){
+        int null = open("/dev/null", O_WRONLY);
+        if(chdir(tmp) != 0 || null < 0)
+            _exit(126);
+        int out = open("stdout", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(out < 0)
+            _exit(126);
+        dup2(out, 1);
+        dup2(null, 2);
+        execv(binary.c_str(), &argv[0]);
+        _exit(127);
+    }
+    int status = 0;
+    if(pid < 0 || waitpid(pid, &status, 0) != pid)
+        return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+/**
+ *  first_difference()
+ *  @param: expected & actual output
+ *  @return: first line where they differ, w/ line number
+ */
+static string first_difference(const string &a, const string &b){
+    istringstream in_a(a), in_b(b);
+    string line_a, line_b;
+    for(int n = 1; ; n++){
+        bool more_a = (bool)getline(in_a, line_a);
+        bool more_b = (bool)getline(in_b, line_b);
+        if(!more_a && !more_b)
+            return "";
+        if(!more_a || !more_b || line_a != line_b){
+            ostringstream ss;
+            ss << "    line " << n << "\n      expected: " << (more_a ? line_a : "<end>")
+               << "\n      dissem:   " << (more_b ? line_b : "<end>") << "\n";
+            return ss.str();
+        }
+    }
+}
+
+static string absolute(const string &path){
+    char buf[PATH_MAX];
+    if(realpath(path.c_str(), buf))
+        return buf;
+    return path;
+}
+
+int main(int argc, char *argv[]){
+    bool update = false;
+    string tests_dir = "tests";
+    string binary = "dissem";
+    for(int i = 1; i < argc; i++){
+        string flag = argv[i];
+        if(flag == "-u")
+            update = true;
+        else if(flag == "-d" && i+1 < argc)
+            tests_dir = argv[++i];
+        else
+            binary = flag;
+    }
+    binary = absolute(binary);
+    tests_dir = absolute(tests_dir);
+    if(access(binary.c_str(), X_OK) != 0){
+        cout<<"***ERROR***\nBuild dissem first (make dissem)."<<endl;
+        return 1;
+    }
+    vector<string> cases = list_dir(tests_dir, true);
+    if(cases.empty()){
+        cout<<"***ERROR***\nNo test cases in "<<tests_dir<<"."<<endl;
+        return 1;
+    }
+    int failed = 0;
+    for(size_t c = 0; c < cases.size(); c++){
+        string dir = tests_dir + "/" + cases[c];
+        string out_dir;
+        bool ok = run_case(binary, dir, out_dir);
+        string report = (ok ? "" : "    dissem failed\n");
+        if(update){
+            // outputs written by this run replace the expected ones
+            vector<string> outputs = list_dir(out_dir, false);
+            for(size_t i = 0; i < outputs.size(); i++){
+                string data;
+                read_file(out_dir + "/" + outputs[i], data);
+                if(outputs[i] != "stdout" || data != "")
+                    write_file(dir + "/" + outputs[i], data);
+            }
+        }
+        else{
+            vector<string> expected = list_dir(dir, false);
+            for(size_t i = 0; i < expected.size(); i++){
+                const string &name = expected[i];
+                if(name == DECK_OBJ || name == DECK_SYM || name == ARGS)
+                    continue;
+                string want, got;
+                read_file(dir + "/" + name, want);
+                if(!read_file(out_dir + "/" + name, got))
+                    report += "    " + name + " not written\n";
+                else if(got != want)
+                    report += "    " + name + " differs\n" + first_difference(want, got);
+            }
+        }
+        remove_dir(out_dir);
+        cout<<(report == "" ? "PASS  " : "FAIL  ")<<cases[c]<<"\n"<<report;
+        if(report != "")
+            failed++;
+    }
+    cout<<(cases.size() - failed)<<" of "<<cases.size()<<" golden tests passed"
+        <<(update ? ", expected outputs updated" : "")<<endl;
+    return (failed ? 1 : 0);
+}
@@ -3,8 +3,28 @@
  *  - Implements Disassembler Class and functions to disassemble object code.
  *  - Reads files provided as command line arguments through class functions.
  *  - Information from files are stored in Disassembler object.
- *  - Makes function calls to read text record object code and to close file
- *    after writing output.
+ *  - Runs the loader/decoder/writer Pipeline over the object deck so reading
+ *    and writing the listing overlap decoding.
+ *  - gzip compressed .obj & .sym files are inflated while being read. Output
+ *    of a compressed deck is only kept if the whole deck inflated cleanly.
+ *  - Control sections of the deck are decoded in parallel by worker threads.
+ *  - Optional flags:
+ *      -s    prints pipeline stats to stderr.
+ *      -j N  decodes control sections & parses .sym tables on N worker
+ *            threads.
+ *      -r A  lists object code relocated to hex load address A, relocated
+ *            statements are marked w/ R.
+ *      -f F  also writes statements as F, a comma separated list of
+ *            jsonl (out.jsonl) & csv (out.csv), from the same decode pass.
+ *      -g    writes basic blocks & call graph to out.dot & out.flow.json.
+ *      -x N  loads the deck (at A when -r is given) and executes up to N
+ *            instructions, writing an execution profile to out.prof.
+ *      -p N  lists only the N hottest addresses in out.prof, all executed
+ *            addresses are listed by default.
+ *      -q R  prints the listing of hex address range R, given as A,B for
+ *            addresses A up to B, to stdout. May be given more than once,
+ *            statements are resolved by the first query & read from the
+ *            decode cache by the others.
  *  @course: [CS530-01 : (Professor: Brian Shen)]
  *  @authors:
  *      - [Omar Martinez(REDID:818749029)]
@@ -14,54 +34,207 @@
 #include <fstream>  // reading and writing to files
 #include <vector>
 #include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
 #include "Disassembler.h"
+#include "Pipeline.h"
+#include "InputFile.h"
+#include "Renderer.h"
+#include "Opcodes.h"
+#include "FlowGraph.h"
+#include "Simulator.h"
 
 using namespace std;
 
+const static size_t SINK_BUFFER = 1 << 16;  // bytes buffered by each output file
+const static string PART_SUFFIX = ".part";  // output kept aside until input is read
 
-const static string ops[] = {
-    "18", "58", "90", "40", "B4", "28",
-    "88", "A0", "24", "64", "9C", "C4",
-    "C0", "F4", "3C", "30", "34", "38",
-    "48", "00", "68", "50", "70", "08",
-    "6C", "74", "04", "D0", "20", "60",
-    "98", "C8", "44", "D8", "AC", "4C",
-    "A4", "A8", "F0", "EC", "0C", "78",
-    "54", "80", "D4", "14", "7C", "E8",
-    "84", "10", "1C", "5C", "94", "B0",
-    "E0", "F8", "2C", "B8", "DC"
-    };
-
-const static string mnemonics[] = {
-    "ADD", "ADDF", "ADDR", "AND", "CLEAR", "COMP",
-    "COMPF", "COMPR", "DIV", "DIVF", "DIVR", "FIX",
-    "FLOAT", "HIO", "J", "JEQ", "JGT", "JLT",
-    "JSUB", "LDA", "LDB", "LDCH", "LDF", "LDL",
-    "LDS", "LDT", "LDX", "LPS", "MUL", "MULF",
-    "MULR", "NORM", "OR", "RD", "RMO", "RSUB",
-    "SHIFTL", "SHIFTR", "SIO", "SSK", "STA",
-    "STB","STCH", "STF", "STI", "STL","STS",
-    "STSW","STT", "STX", "SUB", "SUBF", "SUBR",
-    "SVC","TD", "TIO", "TIX", "TIXR", "WD"
-    };
-
+/**
+ *  commit_part()
+ *  - Moves output written to name.part into name, appending to it or
+ *    replacing it. Does nothing if name.part was not written.
+ *  @param: output file name, true to append to name
+ *  @return: none
+ */
+static void commit_part(const string &name, bool append){
+    string part = name + PART_SUFFIX;
+    ifstream part_file(part.c_str(), ifstream::binary);
+    if(!part_file.is_open())
+        return;
+    if(append){
+        ofstream out_file(name.c_str(), ofstream::out | ofstream::app | ofstream::binary);
+        if(part_file.peek() != ifstream::traits_type::eof())
+            out_file<<part_file.rdbuf();
+        part_file.close();
+        remove(part.c_str());
+    }
+    else{
+        part_file.close();
+        rename(part.c_str(), name.c_str());
+    }
+}
 
 int main(int argc, char *argv[]){
+    bool stats = false;     // print pipeline stats when done
+    // worker threads decoding control sections & parsing .sym tables
+    unsigned int workers = thread::hardware_concurrency();
+    string load_address = "";   // hex load address, empty if not relocating
+    string formats = "";        // extra output formats
+    bool analyse = false;       // build flow graph
+    unsigned long long max_steps = 0;   // instructions to simulate, 0 if not
+    size_t profile_rows = 0;    // addresses listed in profile, 0 for all
+    vector<string> queries;     // hex address ranges "from,to" to print
+    const string usage = string("usage: ") + argv[0] +
+        " <file.obj> <file.sym> [-s] [-j N] [-r addr] [-f jsonl,csv] [-g] [-x N] [-p N] [-q A,B]";
+    if(argc < 3){
+        cout<<usage<<endl;
+        return 1;
+    }
+    for(int i = 3; i < argc; i++){
+        string flag = argv[i];
+        if(flag == "-s")
+            stats = true;
+        else if(flag == "-j" && i+1 < argc)
+            workers = atoi(argv[++i]);
+        else if(flag == "-r" && i+1 < argc)
+            load_address = argv[++i];
+        else if(flag == "-f" && i+1 < argc)
+            formats = string(",") + argv[++i] + ",";
+        else if(flag == "-g")
+            analyse = true;
+        else if(flag == "-x" && i+1 < argc)
+            max_steps = strtoull(argv[++i], NULL, 10);
+        else if(flag == "-p" && i+1 < argc)
+            profile_rows = strtoull(argv[++i], NULL, 10);
+        else if(flag == "-q" && i+1 < argc)
+            queries.push_back(argv[++i]);
+    }
+    // every name listed w/ -f must be a known format
+    for(size_t pos = 1; pos < formats.size(); pos = formats.find(',', pos) + 1){
+        string name = formats.substr(pos, formats.find(',', pos) - pos);
+        if(name != "jsonl" && name != "csv"){
+            cout<<"***ERROR***\nUnknown output format '"<<name<<"'."<<endl;
+            cout<<usage<<endl;
+            return 1;
+        }
+    }
+    // every range given w/ -q must have both addresses
+    for(size_t i = 0; i < queries.size(); i++){
+        size_t comma = queries[i].find(',');
+        if(comma == string::npos || comma == 0 || comma+1 == queries[i].size()){
+            cout<<"***ERROR***\nAddress range '"<<queries[i]<<"' is not A,B."<<endl;
+            cout<<usage<<endl;
+            return 1;
+        }
+    }
     // creating Disassembler object and passing arrays to create hashmap.
     Disassembler ds(mnemonics, ops); // [key,value] = [op,mnemonic]
 
-    // calling method to open file test.obj and store into vector array
-    if(!ds.read_obj_file(argv[1])){ // read in object code, return true if read. false otherwise.
+    // open object code file, records are read by the pipeline loader stage
+    InputFile obj_file;
+    if(!obj_file.open(argv[1])){
+        cout<<obj_file.get_error()<<endl;
         return 1;   // terminite program if file could not be read
     }
 
     // calling method to open file and map symbol and literal table from test.sym
-    if(!ds.read_sym_file(argv[2])){
+    if(!ds.read_sym_file(argv[2], workers)){
         return 1;   // terminate program if file could not be read
     }
-    ds.read_header_row();   // read header record
-    ds.read_text_record();  // read text records
-    ds.read_end_record();   // print end record
-    ds.close_file();
+    // opening file to log SIC/XE statements into w/o overwritting
+    vector<char> lst_buf(SINK_BUFFER), json_buf(SINK_BUFFER), csv_buf(SINK_BUFFER);
+    ofstream lst_file, json_file, csv_file;
+    // a corrupt gzip stream is only found once it is read, so output of a
+    // compressed deck is written to .part files first and kept if complete
+    string part = (obj_file.is_compressed() ? PART_SUFFIX : "");
+    lst_file.rdbuf()->pubsetbuf(&lst_buf[0], lst_buf.size());
+    if(part == "")
+        lst_file.open("out.lst", ofstream::out | ofstream::app);
+    else
+        lst_file.open("out.lst" + part, ofstream::out | ofstream::trunc);
+    Pipeline pipeline(ds, obj_file.stream(), lst_file, workers);
+    JsonRenderer json;
+    CsvRenderer csv;
+    if(formats.find(",jsonl,") != string::npos){
+        json_file.rdbuf()->pubsetbuf(&json_buf[0], json_buf.size());
+        json_file.open("out.jsonl" + part, ofstream::out | ofstream::trunc);
+        pipeline.add_output(json, json_file);
+    }
+    if(formats.find(",csv,") != string::npos){
+        csv_file.rdbuf()->pubsetbuf(&csv_buf[0], csv_buf.size());
+        csv_file.open("out.csv" + part, ofstream::out | ofstream::trunc);
+        pipeline.add_output(csv, csv_file);
+    }
+    FlowGraph graph;
+    if(analyse)
+        pipeline.add_analysis(graph);
+    if(load_address != "")
+        pipeline.set_load_address(ds.hex_to_int(load_address));
+    pipeline.run();     // read header, text and end records
+    lst_file.close();
+    json_file.close();
+    csv_file.close();
+    if(obj_file.is_corrupt()){
+        if(part != ""){
+            remove(("out.lst" + part).c_str());
+            remove(("out.jsonl" + part).c_str());
+            remove(("out.csv" + part).c_str());
+        }
+        cout<<"***ERROR***\nCompressed object file is corrupt."<<endl;
+        return 1;
+    }
+    if(part != ""){
+        commit_part("out.lst", true);
+        commit_part("out.jsonl", false);
+        commit_part("out.csv", false);
+    }
+    if(analyse){
+        ofstream dot_file("out.dot"), flow_file("out.flow.json");
+        graph.write_dot(dot_file);
+        graph.write_json(flow_file);
+    }
+    // deck is read again into the Disassembler for range queries. The first
+    // section's decode cache was filled by the pipeline.
+    if(queries.size()){
+        if(!ds.read_obj_file(argv[1]))
+            return 1;
+        ListingRenderer listing;
+        for(size_t i = 0; i < queries.size(); i++){
+            size_t comma = queries[i].find(',');
+            vector<Statement> statements;
+            ds.read_range(ds.hex_to_int(queries[i].substr(0, comma)),
+                          ds.hex_to_int(queries[i].substr(comma+1)), statements);
+            string buf;
+            for(size_t j = 0; j < statements.size(); j++)
+                listing.render(statements[j], buf);
+            cout<<buf;
+        }
+    }
+    if(stats){
+        pipeline.print_stats(cerr);
+        if(analyse)
+            graph.print_stats(cerr);
+        if(queries.size())
+            cerr<<"range queries:    "<<ds.get_range_hits()<<" statements from decode cache, "
+                <<ds.get_range_misses()<<" resolved, "<<ds.get_cache_hits()
+                <<" decisions from decode cache\n";
+    }
+    // deck is read again so the simulator loads it w/o the pipeline. Its
+    // memory is only allocated when simulating.
+    if(max_steps){
+        InputFile sim_file;
+        if(!sim_file.open(argv[1])){
+            cout<<sim_file.get_error()<<endl;
+            return 1;
+        }
+        Simulator sim(ds);
+        sim.load(sim_file.stream(), load_address != "", ds.hex_to_int(load_address));
+        sim.run(max_steps);
+        ofstream prof_file("out.prof");
+        sim.write_profile(prof_file, profile_rows);
+        if(stats)
+            sim.print_stats(cerr);
+    }
     return 0;
-}
\ No newline at end of file
+}
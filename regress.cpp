@@ -0,0 +1,524 @@
+/**
+ *  regress.cpp
+ *  - Regression gate comparing dissem against dissem_ref, the original
+ *    disassembler kept unchanged in ref/.
+ *  - Inputs are test.obj/test.sym plus generated decks of a few sizes. Decks
+ *    are generated the same way every run and only use what the original
+ *    handles: one control section, labels away from record starts, RESB
+ *    gaps w/ a symbol at their start and no base relative addressing.
+ *  - Each binary runs in its own temp directory so their out.lst files do
+ *    not mix. Wall time is the best of several runs, peak memory comes from
+ *    wait4().
+ *  - Listings must match byte for byte. Inputs taking the reference at
+ *    least MIN_TIMED seconds must not be slower than the threshold.
+ *  - Results are appended to a tab separated file, one row per input.
+ *      regress [-n sizes] [-r runs] [-t slowdown] [-o results] [-k]
+ *              [-p file.obj file.sym] [dissem [dissem_ref]]
+ *          -n sizes    comma separated instruction counts of generated decks
+ *          -r runs     runs of each binary per input, fastest is kept
+ *          -t slowdown highest accepted dissem time / dissem_ref time
+ *          -o results  file results are appended to
+ *          -k          keeps generated decks in regress-decks/
+ *          -p          adds an .obj/.sym pair as input
+ *  @course: [CS530-01 : (Professor: Brian Shen)]
+ *  @authors:
+ *      - [Omar Martinez(REDID:818749029)]
+ *      - [Nick Riazanov(REDID:819099418)]
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <climits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace std;
+
+const static double MIN_TIMED = 0.05;       // faster inputs are too noisy to judge
+const static unsigned int RECORD_BYTES = 30;    // bytes in a full text record
+const static unsigned int LABEL_EVERY = 32;     // instructions per label, about
+
+// object deck & symbol file to run both binaries on
+struct Input
+{
+    string name;
+    string obj, sym;
+};
+
+// one run of a binary on an input
+struct Run
+{
+    bool ok;
+    double seconds;
+    long maxrss_kb;
+    string listing;
+};
+
+// xorshift, decks are the same every run
+static uint32_t rng_state;
+static uint32_t rng(){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static string hex(unsigned int value, int digits){
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%0*X", digits, value);
+    return buf;
+}
+
+// format 3 & 4 opcodes used by generated decks, n & i bits clear
+const static unsigned char MEMORY_OPS[] = {
+    0x00, 0x04, 0x08, 0x0C, 0x10, 0x14, 0x18, 0x1C, 0x20, 0x24, 0x28, 0x2C,
+    0x30, 0x34, 0x38, 0x3C, 0x40, 0x44, 0x48, 0x50, 0x54, 0xD8, 0xDC, 0xE0
+    };
+// format 2 opcodes: ADDR, CLEAR, COMPR, RMO, TIXR
+const static unsigned char REGISTER_OPS[] = {0x90, 0xB4, 0xA0, 0xAC, 0xB8};
+
+// instruction, constant or reserved bytes of a generated deck
+struct Item
+{
+    enum Kind { FORMAT2, FORMAT3, FORMAT4, RSUB, CONSTANT, LITERAL, RESERVED };
+    Kind kind;
+    unsigned int address, length;
+    // opcode of instructions, bytes of constants
+    unsigned int op;
+    string bytes;
+    // label at address, if any
+    string label;
+    bool record_start;
+};
+
+/**
+ *  pick_target()
+ *  - The original disassembler takes a displacement as negative when the
+ *    lowest bit of its first nibble is set, so only displacements where that
+ *    bit matches the sign are picked. Format 4 addresses, pc < 0, need that
+ *    bit clear.
+ *  @param: sorted target addresses, pc, lowest & highest address accepted
+ *  @return: random target in range, -1 if none
+ */
+static long pick_target(const vector<unsigned int> &targets, long pc, long lo, long hi){
+    vector<unsigned int>::const_iterator first =
+        lower_bound(targets.begin(), targets.end(), (unsigned int)max(lo, 0L));
+    vector<unsigned int>::const_iterator last =
+        upper_bound(targets.begin(), targets.end(), (unsigned int)max(hi, 0L));
+    if(hi < 0 || first >= last)
+        return -1;
+    for(int tries = 0; tries < 8; tries++){
+        long target = *(first + rng() % (last - first));
+        long disp = target - pc;
+        if(pc < 0 ? ((target >> 16) & 1) == 0 : (((disp & 0xFFF) >> 8) & 1) == (disp < 0))
+            return target;
+    }
+    return -1;
+}
+/**
+ *  generate_deck()
+ *  - Lays out instructions, constants & RESB gaps, splits them into text
+ *    records, labels some instructions, then resolves operands to labels,
+ *    constants & literals within reach.
+ *  - Format 4 instructions get a modification record.
+ *  @param: number of instructions, seed, deck to fill in
+ *  @return: none
+ */
+static void generate_deck(unsigned int num_instructions, uint32_t seed, Input &deck){
+    rng_state = seed;
+    vector<Item> items;
+    unsigned int addr = 0, count = 0;
+    while(count < num_instructions){
+        Item it = Item();
+        it.address = addr;
+        unsigned int r = rng() % 100;
+        if(r < 2 && count > 0){
+            it.kind = Item::RESERVED;
+            it.length = 1 + rng() % 200;
+        }
+        else if(r < 8){
+            it.kind = (r < 6 ? Item::CONSTANT : Item::LITERAL);
+            it.length = 1 + rng() % 3;
+            for(unsigned int i = 0; i < it.length; i++)
+                it.bytes += hex(rng() & 0xFF, 2);
+        }
+        else{
+            r = rng() % 100;
+            it.kind = (r < 10 ? Item::FORMAT2 : (r < 25 ? Item::FORMAT4 :
+                      (r < 30 ? Item::RSUB : Item::FORMAT3)));
+            it.length = (it.kind == Item::FORMAT2 ? 2 : (it.kind == Item::FORMAT4 ? 4 : 3));
+            count++;
+        }
+        items.push_back(it);
+        addr += it.length;
+    }
+    // program ends w/ reserved bytes
+    Item end = Item();
+    end.kind = Item::RESERVED;
+    end.address = addr;
+    end.length = 1 + rng() % 200;
+    items.push_back(end);
+    unsigned int prog_length = addr + end.length;
+
+    // records break at reserved bytes & when full
+    unsigned int record_bytes = RECORD_BYTES;
+    for(size_t i = 0; i < items.size(); i++){
+        if(items[i].kind == Item::RESERVED){
+            record_bytes = RECORD_BYTES;
+            continue;
+        }
+        if(record_bytes + items[i].length > RECORD_BYTES){
+            items[i].record_start = true;
+            record_bytes = 0;
+        }
+        record_bytes += items[i].length;
+    }
+    // a symbol at a record start would be listed as RESB 0 by the end of the
+    // record before, so only the first one is labeled
+    vector<unsigned int> targets, code_labels;
+    unsigned int num_labels = 0, num_constants = 0;
+    for(size_t i = 0; i < items.size(); i++){
+        Item &it = items[i];
+        bool code = (it.kind != Item::CONSTANT && it.kind != Item::LITERAL
+                     && it.kind != Item::RESERVED);
+        if(it.kind == Item::RESERVED)
+            it.label = "R" + hex(num_labels++, 5);
+        else if(it.kind == Item::CONSTANT)
+            it.label = "C" + hex(num_constants++, 5);
+        else if(i == 0)
+            it.label = "FIRST";
+        else if(code && !it.record_start && rng() % LABEL_EVERY == 0)
+            it.label = "L" + hex(num_labels++, 5);
+        if(it.label != "" || it.kind == Item::LITERAL)
+            targets.push_back(it.address);
+    }
+
+    string text, modifications;
+    string record;
+    unsigned int record_addr = 0;
+    for(size_t i = 0; i < items.size(); i++){
+        Item &it = items[i];
+        if(it.record_start || it.kind == Item::RESERVED){
+            if(record != "")
+                text += "T" + hex(record_addr, 6) + hex(record.length() / 2, 2) + record + "\n";
+            record = "";
+            record_addr = it.address;
+        }
+        if(it.kind == Item::RESERVED)
+            continue;
+        unsigned int next = it.address + it.length;
+        switch(it.kind){
+        case Item::FORMAT2:{
+            unsigned int op = REGISTER_OPS[rng() % sizeof(REGISTER_OPS)];
+            unsigned int r1 = rng() % 7, r2 = (op == 0xB4 || op == 0xB8 ? 0 : rng() % 7);
+            record += hex(op, 2) + hex(r1, 1) + hex(r2, 1);
+            break;
+        }
+        case Item::FORMAT3:{
+            unsigned int op = MEMORY_OPS[rng() % sizeof(MEMORY_OPS)];
+            unsigned int mode = rng() % 100;
+            long target = pick_target(targets, next, (long)next - 2048, (long)next + 2047);
+            unsigned int ni = (mode < 70 ? 3 : (mode < 85 ? 2 : 1));
+            if(target < 0 || (ni == 1 && mode >= 95)){
+                // immediate constant, no target
+                record += hex(op | 1, 2) + "0" + hex(rng() % 4096, 3);
+                break;
+            }
+            unsigned int disp = (unsigned int)(target - (long)next) & 0xFFF;
+            record += hex(op | ni, 2) + "2" + hex(disp, 3);
+            break;
+        }
+        case Item::FORMAT4:{
+            unsigned int op = MEMORY_OPS[rng() % sizeof(MEMORY_OPS)];
+            long target = pick_target(targets, -1, 0, prog_length);
+            record += hex(op | 3, 2) + "1" + hex(target < 0 ? 0 : target, 5);
+            modifications += "M" + hex(it.address + 1, 6) + "05\n";
+            break;
+        }
+        case Item::RSUB:
+            record += "4F0000";
+            break;
+        default:
+            record += it.bytes;
+        }
+    }
+    if(record != "")
+        text += "T" + hex(record_addr, 6) + hex(record.length() / 2, 2) + record + "\n";
+    deck.obj = "HGENDCK000000" + hex(prog_length, 6) + "\n" + text + modifications + "E000000\n";
+
+    string symbols, literals;
+    for(size_t i = 0; i < items.size(); i++){
+        const Item &it = items[i];
+        string row;
+        if(it.kind == Item::CONSTANT || it.kind == Item::LITERAL){
+            string name = (it.kind == Item::LITERAL ? "" : it.label);
+            string constant = (it.kind == Item::LITERAL ? "=X'" : "X'") + it.bytes + "'";
+            name.resize(8, ' ');
+            constant.resize(12, ' ');
+            string length = to_string(it.bytes.length());
+            length.resize(4, ' ');
+            literals += name + constant + length + hex(it.address, 6) + "\n";
+        }
+        else if(it.label != ""){
+            row = it.label;
+            row.resize(8, ' ');
+            symbols += row + hex(it.address, 6) + "  R\n";
+        }
+    }
+    deck.sym = "Symbol  Address Flags:\n-----------------------\n" + symbols
+               + "\nName    Lit_Const  Length Address:\n------------------------------\n"
+               + literals;
+}
+
+static bool read_file(const string &filename, string &data){
+    ifstream file(filename.c_str(), ifstream::binary);
+    if(!file.is_open())
+        return false;
+    ostringstream ss;
+    ss << file.rdbuf();
+    data = ss.str();
+    return true;
+}
+
+static bool write_file(const string &filename, const string &data){
+    ofstream file(filename.c_str(), ofstream::binary);
+    file << data;
+    return file.good();
+}
+/**
+ *  remove_dir()
+ *  - Directories made by the gate only hold files.
+ *  @param: directory
+ *  @return: none
+ */
+static void remove_dir(const string &dir){
+    DIR *d = opendir(dir.c_str());
+    if(d){
+        struct dirent *e;
+        while((e = readdir(d)) != NULL){
+            string name = e->d_name;
+            if(name != "." && name != "..")
+                unlink((dir + "/" + name).c_str());
+        }
+        closedir(d);
+    }
+    rmdir(dir.c_str());
+}
+/**
+ *  run_binary()
+ *  - Child changes into a fresh temp directory, so out.lst starts empty.
+ *    Its stdout & stderr are discarded.
+ *  @param: absolute paths of binary, object deck & symbol file, run to fill in
+ *  @return: none
+ */
+static void run_binary(const string &binary, const string &obj, const string &sym, Run &run){
+    char dir[] = "/tmp/regress.XXXXXX";
+    run.ok = false;
+    run.seconds = 0;
+    run.maxrss_kb = 0;
+    run.listing = "";
+    if(!mkdtemp(dir)){
+        perror("mkdtemp");
+        return;
+    }
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if(pid == 0){
+        int null = open("/dev/null", O_WRONLY);
+        if(chdir(dir) != 0 || null < 0)
+            _exit(126);
+        dup2(null, 1);
+        dup2(null, 2);
+        execl(binary.c_str(), binary.c_str(), obj.c_str(), sym.c_str(), (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage usage;
+    if(pid > 0 && wait4(pid, &status, 0, &usage) == pid){
+        run.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        run.maxrss_kb = usage.ru_maxrss;
+        run.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        read_file(string(dir) + "/out.lst", run.listing);
+    }
+    remove_dir(dir);
+}
+/**
+ *  best_run()
+ *  @param: binary, object deck, symbol file, number of runs
+ *  @return: fastest run w/ highest peak memory of all runs
+ */
+static Run best_run(const string &binary, const string &obj, const string &sym, int runs){
+    Run best;
+    run_binary(binary, obj, sym, best);
+    for(int i = 1; i < runs && best.ok; i++){
+        Run r;
+        run_binary(binary, obj, sym, r);
+        best.maxrss_kb = max(best.maxrss_kb, r.maxrss_kb);
+        if(r.seconds < best.seconds)
+            best.seconds = r.seconds;
+    }
+    return best;
+}
+/**
+ *  first_difference()
+ *  @param: two listings
+ *  @return: first line where they differ, w/ line number
+ */
+static string first_difference(const string &a, const string &b){
+    istringstream in_a(a), in_b(b);
+    string line_a, line_b;
+    for(int n = 1; ; n++){
+        bool more_a = (bool)getline(in_a, line_a);
+        bool more_b = (bool)getline(in_b, line_b);
+        if(!more_a && !more_b)
+            return "";
+        if(!more_a || !more_b || line_a != line_b){
+            ostringstream ss;
+            ss << "  line " << n << "\n    dissem_ref: " << (more_a ? line_a : "<end>")
+               << "\n    dissem:     " << (more_b ? line_b : "<end>") << "\n";
+            return ss.str();
+        }
+    }
+}
+
+static string absolute(const string &path){
+    char buf[PATH_MAX];
+    if(realpath(path.c_str(), buf))
+        return buf;
+    return path;
+}
+
+static double throughput(size_t bytes, double seconds){
+    return (seconds > 0 ? bytes / seconds / 1e6 : 0);
+}
+
+int main(int argc, char *argv[]){
+    string sizes = "1000,10000,50000";
+    int runs = 3;
+    double max_slowdown = 1.2;
+    string results = "regress.tsv";
+    bool keep = false;
+    vector<string> binaries;
+    vector<Input> inputs;
+    Input sample;
+    if(read_file("test.obj", sample.obj) && read_file("test.sym", sample.sym)){
+        sample.name = "test.obj";
+        inputs.push_back(sample);
+    }
+    for(int i = 1; i < argc; i++){
+        string flag = argv[i];
+        if(flag == "-n" && i+1 < argc)
+            sizes = argv[++i];
+        else if(flag == "-r" && i+1 < argc)
+            runs = max(1, atoi(argv[++i]));
+        else if(flag == "-t" && i+1 < argc)
+            max_slowdown = atof(argv[++i]);
+        else if(flag == "-o" && i+1 < argc)
+            results = argv[++i];
+        else if(flag == "-k")
+            keep = true;
+        else if(flag == "-p" && i+2 < argc){
+            Input in;
+            in.name = argv[i+1];
+            if(!read_file(argv[i+1], in.obj) || !read_file(argv[i+2], in.sym)){
+                cout<<"***ERROR***\nFile not found. Exitting program."<<endl;
+                return 1;
+            }
+            inputs.push_back(in);
+            i += 2;
+        }
+        else
+            binaries.push_back(flag);
+    }
+    string binary = absolute(binaries.size() > 0 ? binaries[0] : "dissem");
+    string reference = absolute(binaries.size() > 1 ? binaries[1] : "dissem_ref");
+    if(access(binary.c_str(), X_OK) != 0 || access(reference.c_str(), X_OK) != 0){
+        cout<<"***ERROR***\nBuild dissem & dissem_ref first (make dissem dissem_ref)."<<endl;
+        return 1;
+    }
+    stringstream size_list(sizes);
+    string size;
+    while(getline(size_list, size, ',')){
+        unsigned int n = strtoul(size.c_str(), NULL, 10);
+        if(n == 0)
+            continue;
+        Input deck;
+        deck.name = "gen" + size;
+        generate_deck(n, 2463534242u + n, deck);
+        inputs.push_back(deck);
+    }
+
+    // decks are written to disk once, both binaries read the same files
+    string deck_dir = "regress-decks";
+    char tmp_dir[] = "/tmp/regress-decks.XXXXXX";
+    if(keep)
+        mkdir(deck_dir.c_str(), 0755);
+    else if(mkdtemp(tmp_dir))
+        deck_dir = tmp_dir;
+    else{
+        perror("mkdtemp");
+        return 1;
+    }
+    bool new_file = (access(results.c_str(), F_OK) != 0);
+    ofstream out(results.c_str(), ofstream::out | ofstream::app);
+    if(new_file)
+        out << "date\tinput\tbytes\tlines\tref_s\tnew_s\tref_MB/s\tnew_MB/s"
+               "\tref_peak_KB\tnew_peak_KB\tslowdown\tresult\n";
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    int failures = 0;
+    for(size_t i = 0; i < inputs.size(); i++){
+        const Input &in = inputs[i];
+        string base = deck_dir + "/" + to_string(i) + "-";
+        string obj = base + "deck.obj", sym = base + "deck.sym";
+        if(!write_file(obj, in.obj) || !write_file(sym, in.sym)){
+            cout<<"***ERROR***\nCould not write "<<obj<<endl;
+            return 1;
+        }
+        obj = absolute(obj);
+        sym = absolute(sym);
+        Run ref = best_run(reference, obj, sym, runs);
+        Run cur = best_run(binary, obj, sym, runs);
+        size_t lines = count(ref.listing.begin(), ref.listing.end(), '\n');
+        double slowdown = (ref.seconds > 0 ? cur.seconds / ref.seconds : 0);
+        string result = "ok";
+        if(!ref.ok || !cur.ok)
+            result = "FAILED";
+        else if(ref.listing != cur.listing)
+            result = "DIFF";
+        else if(ref.seconds >= MIN_TIMED && slowdown > max_slowdown)
+            result = "SLOW";
+        if(result != "ok")
+            failures++;
+        out << date << "\t" << in.name << "\t" << in.obj.length() << "\t" << lines
+            << "\t" << ref.seconds << "\t" << cur.seconds
+            << "\t" << throughput(in.obj.length(), ref.seconds)
+            << "\t" << throughput(in.obj.length(), cur.seconds)
+            << "\t" << ref.maxrss_kb << "\t" << cur.maxrss_kb
+            << "\t" << slowdown << "\t" << result << "\n";
+        cout << in.name << ": " << in.obj.length() << " bytes, " << lines << " lines, "
+             << ref.seconds << " s -> " << cur.seconds << " s (x" << slowdown << "), "
+             << ref.maxrss_kb << " KB -> " << cur.maxrss_kb << " KB peak, " << result << "\n";
+        if(result == "DIFF")
+            cout << first_difference(ref.listing, cur.listing);
+    }
+    if(!keep)
+        remove_dir(deck_dir);
+    cout << (failures ? "FAILED: " : "passed: ") << inputs.size() - failures << "/"
+         << inputs.size() << " inputs, results appended to " << results << endl;
+    return (failures ? 1 : 0);
+}